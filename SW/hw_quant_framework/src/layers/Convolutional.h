@@ -25,6 +25,7 @@ class ConvolutionalLayer : public Layer {
         Layer::allocLayer();
         weightData.loadData();
         biasData.loadData();
+        mac_pairs.reserve(weightParam.dims[0] * weightParam.dims[1] * weightParam.dims[2]);  // R * S * C
     }
 
     // Fre all resources allocated for the layer
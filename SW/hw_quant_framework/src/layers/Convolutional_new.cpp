@@ -381,12 +381,7 @@ void ConvolutionalLayer::computeQuantizedInternal(const LayerData &dataIn, bool
         const bool hardware_enabled = false;
 #endif
 
-        std::vector<uint16_t> mac_pairs;
-#if defined(ZEDBOARD)
-        if (hardware_enabled) {
-            mac_pairs.reserve(R * S * C);
-        }
-#endif
+        mac_pairs.clear();
         
         // ==========================================================================
         // ADAPTIVE INPUT CALIBRATION SELECTION FOR CONVOLUTIONAL LAYERS
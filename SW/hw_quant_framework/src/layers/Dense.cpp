@@ -297,12 +297,7 @@ namespace ML
         const bool hardware_enabled = false;
 #endif
 
-        std::vector<uint16_t> mac_pairs;
-#if defined(ZEDBOARD)
-        if (hardware_enabled) {
-            mac_pairs.reserve(totalInputFeatures);
-        }
-#endif
+        mac_pairs.clear();
         
         // ==========================================================================
         // ADAPTIVE CALIBRATION SELECTION FOR DENSE LAYERS
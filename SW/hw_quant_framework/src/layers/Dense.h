@@ -25,6 +25,7 @@ class DenseLayer : public Layer {
         Layer::allocLayer();
         weightData.loadData();
         biasData.loadData();
+        mac_pairs.reserve(weightParam.dims[0]);  // Input features
     }
 
     // Free all resources allocated for the layer
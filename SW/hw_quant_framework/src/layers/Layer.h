@@ -179,6 +179,7 @@ class Layer {
 
     virtual void freeLayer() {
         outData.freeData();
+        std::vector<uint16_t>().swap(mac_pairs);
     }
 
     virtual void computeNaive(const LayerData& dataIn) const = 0;
@@ -206,6 +207,10 @@ class Layer {
     std::vector<int32_t> quantized_biases;
     bool weights_quantized = false;
 
+    // Operand pairs of one HardwareMac::run, owned by the layer: reserved in allocLayer for
+    // the longest dot product, so inference never reallocates it
+    mutable std::vector<uint16_t> mac_pairs;
+
    private:
     LayerParams inParams;
     LayerParams outParams;
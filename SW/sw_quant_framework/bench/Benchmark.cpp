@@ -0,0 +1,504 @@
+// Kernel benchmark: times every layer of the toy model, and a set of synthetic layer shapes,
+// under each inference type with warmup and repeated runs. Reports latency percentiles, the
+// achieved GOPS / GB/s and how close each run gets to a measured roofline of this machine,
+// then the fastest inference type per shape (the default kernel to pick for it). Like
+// autoTune, a type whose output drifts from NAIVE (cosine below 1 - Config::EPSILON) is
+// reported but cannot be picked.
+// The roofline uses DRAM copy bandwidth, so layers whose working set stays in cache can
+// exceed 100%. fp32 rows are bound by an fp32 FMA chain and fp32 traffic; QUANTIZED rows
+// by an int8 row MAC (the quantized kernels' inner loop) and int8 inputs and weights.
+// A drifting QUANTIZED row can exceed 100% too: zero skipping drops the MACs of inputs
+// that quantize to the zero point.
+//
+//   make bench                 Quick run of every case
+//   ./build/bench [options]
+//     --reps N                 Timed runs per case (default 10)
+//     --warmup N               Untimed runs before timing (default 2)
+//     --types LIST             Subset of naive,threaded,tiled,simd,quantized (default all)
+//     --threads LIST           Shared pool sizes swept for THREADED (default 1 and all hardware threads)
+//     --no-toy, --no-synthetic Skip the toy model layers / the synthetic shapes
+//     --data DIR               Toy model data directory (default data)
+//     --csv PATH               Write one row per case
+//     --baseline PATH          Compare p50 against the --csv of an earlier run; exit 1 on a regression
+//     --tolerance F            Allowed p50 slowdown against the baseline (default 0.10)
+//     --quick                  Same as --reps 3 --warmup 1
+//
+// Run from the framework directory (the quantized kernels look for data/calibration_stats*.json).
+// Host only: it uses the shared thread pool and writes synthetic weights under build/bench_data.
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Config.h"
+#include "Graph.h"
+#include "Model.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "ToyModel.h"
+#include "Utils.h"
+#include "layers/Convolutional.h"
+#include "layers/Dense.h"
+#include "layers/MaxPooling.h"
+
+using namespace ML;
+
+namespace {
+
+struct Options {
+    std::size_t reps = 10;
+    std::size_t warmup = 2;
+    std::vector<Layer::InfType> types = {Layer::InfType::NAIVE, Layer::InfType::THREADED, Layer::InfType::TILED,
+                                         Layer::InfType::SIMD, Layer::InfType::QUANTIZED};
+    std::vector<std::size_t> threads;  // Empty: 1 and all hardware threads
+    bool toy = true;
+    bool synthetic = true;
+    Path dataDir = "data";
+    std::string csvPath;
+    std::string baselinePath;
+    double tolerance = 0.10;
+};
+
+// One layer under test, the input it reads and its NAIVE output
+struct BenchCase {
+    std::string name;   // "L2 conv", "S1 conv"
+    std::string shape;  // "60x60x32 -> 56x56x32"
+    const Layer* layer;
+    const LayerData* input;
+    const LayerData* reference;
+    int convIndex;  // Index among the toy model's convs (its calibration stats), -1 otherwise
+};
+
+struct Result {
+    std::string name;
+    std::string shape;
+    Layer::InfType infType;
+    std::size_t threads;
+    double minMs, meanMs, p50Ms, p90Ms;
+    double gops, gbps;  // At p50
+    double roofPct;     // Roofline-bound time over p50 time
+    double cosine;      // Output against NAIVE
+    bool accurate;      // Within the autoTune tolerance, so it may be picked
+};
+
+// Measured peaks of this machine (one thread)
+struct Roofline {
+    double gflops;     // fp32 multiply-add
+    double int8Gops;   // int8 x int8 -> int32 multiply-add
+    double gbps;
+};
+
+std::string dimsString(const std::vector<std::size_t>& dims) {
+    std::string s;
+    for (std::size_t i = 0; i < dims.size(); i++) {
+        s += (i ? "x" : "") + std::to_string(dims[i]);
+    }
+    return s;
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+Layer::InfType parseType(std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    const Layer::InfType types[] = {Layer::InfType::NAIVE, Layer::InfType::THREADED, Layer::InfType::TILED,
+                                    Layer::InfType::SIMD, Layer::InfType::QUANTIZED};
+    for (Layer::InfType type : types) {
+        if (name == Profiler::infTypeName(type)) return type;
+    }
+    throw std::runtime_error("Unknown inference type: " + name);
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--reps") {
+            opt.reps = std::max(1, std::atoi(value().c_str()));
+        } else if (arg == "--warmup") {
+            opt.warmup = std::max(0, std::atoi(value().c_str()));
+        } else if (arg == "--types") {
+            opt.types.clear();
+            for (const std::string& name : splitList(value())) opt.types.push_back(parseType(name));
+        } else if (arg == "--threads") {
+            for (const std::string& n : splitList(value())) opt.threads.push_back(std::max(1, std::atoi(n.c_str())));
+        } else if (arg == "--no-toy") {
+            opt.toy = false;
+        } else if (arg == "--no-synthetic") {
+            opt.synthetic = false;
+        } else if (arg == "--data") {
+            opt.dataDir = value();
+        } else if (arg == "--csv") {
+            opt.csvPath = value();
+        } else if (arg == "--baseline") {
+            opt.baselinePath = value();
+        } else if (arg == "--tolerance") {
+            opt.tolerance = std::atof(value().c_str());
+        } else if (arg == "--quick") {
+            opt.reps = 3;
+            opt.warmup = 1;
+        } else {
+            throw std::runtime_error("Unknown option: " + arg + " (see the top of bench/Benchmark.cpp)");
+        }
+    }
+    if (opt.threads.empty()) {
+        opt.threads.push_back(1);
+        const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        if (hw > 1) opt.threads.push_back(hw);
+    }
+    return opt;
+}
+
+// Copy bandwidth (bytes read + written), FMA-chain throughput and int8 MAC throughput of one core
+Roofline measureRoofline() {
+    using Clock = std::chrono::steady_clock;
+    Roofline roof = {0.0, 0.0, 0.0};
+
+    const std::size_t bytes = 64u << 20;  // Well past the last-level cache
+    std::vector<char> src(bytes, 1), dst(bytes, 0);
+    for (int rep = 0; rep < 5; rep++) {
+        const Clock::time_point begin = Clock::now();
+        std::memcpy(dst.data(), src.data(), bytes);
+        const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        roof.gbps = std::max(roof.gbps, 2.0 * bytes / seconds / 1e9);
+        src[rep] = dst[bytes - 1 - rep];  // Keep the copies observable
+    }
+
+    // Independent multiply-add chains, enough of them to hide the latency once vectorized
+    const std::size_t lanes = 64, iterations = 4u << 20;
+    float acc[lanes];
+    for (std::size_t j = 0; j < lanes; j++) acc[j] = 1.0f + j * 1e-3f;
+    const float a = 0.999999f, b = 1e-7f;
+    for (int rep = 0; rep < 3; rep++) {
+        const Clock::time_point begin = Clock::now();
+        for (std::size_t i = 0; i < iterations; i++) {
+            for (std::size_t j = 0; j < lanes; j++) acc[j] = acc[j] * a + b;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        roof.gflops = std::max(roof.gflops, 2.0 * lanes * iterations / seconds / 1e9);
+    }
+
+    // int32 accumulators += int8 input * int8 weight row, rows cycling through an L1-sized
+    // block (the pattern of accumulateInt8Row)
+    const std::size_t rows = 256;
+    std::vector<i8> weights(rows * lanes), inputs(rows);
+    for (std::size_t i = 0; i < weights.size(); i++) weights[i] = static_cast<i8>(i * 7 % 255 - 127);
+    for (std::size_t i = 0; i < rows; i++) inputs[i] = static_cast<i8>(i * 13 % 255 - 127);
+    i32 acc8[lanes] = {};
+    for (int rep = 0; rep < 3; rep++) {
+        const Clock::time_point begin = Clock::now();
+        for (std::size_t i = 0; i < iterations; i++) {
+            const i8* row = weights.data() + (i % rows) * lanes;
+            const i32 x = inputs[i % rows];
+            for (std::size_t j = 0; j < lanes; j++) acc8[j] += x * row[j];
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        roof.int8Gops = std::max(roof.int8Gops, 2.0 * lanes * iterations / seconds / 1e9);
+    }
+
+    float sum = 0.0f;
+    for (std::size_t j = 0; j < lanes; j++) sum += acc[j] + acc8[j];
+    volatile float sink = sum + src[0];
+    (void)sink;
+    return roof;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    const std::size_t rank = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+Result runCase(const BenchCase& c, Layer::InfType infType, std::size_t threads, const Options& opt,
+               const Roofline& roof) {
+    // Each run of a toy conv takes the layer-specific stats of its place in the chain
+    auto calibrate = [&]() {
+        if (c.convIndex >= 0) setConvLayerCounter(c.convIndex);
+    };
+    for (std::size_t i = 0; i < opt.warmup; i++) {
+        calibrate();
+        c.layer->compute(*c.input, infType);
+    }
+    std::vector<double> samples;
+    for (std::size_t i = 0; i < opt.reps; i++) {
+        calibrate();
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        c.layer->compute(*c.input, infType);
+        samples.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Result r;
+    r.name = c.name;
+    r.shape = c.shape;
+    r.infType = infType;
+    r.threads = threads;
+    r.minMs = samples.front();
+    r.p50Ms = percentile(samples, 0.5);
+    r.p90Ms = percentile(samples, 0.9);
+    double total = 0.0;
+    for (double s : samples) total += s;
+    r.meanMs = total / samples.size();
+
+    const CompareMetrics metrics = c.layer->getOutputData().compareMetrics<fp32>(*c.reference);
+    r.cosine = metrics.cosine;
+    r.accurate = metrics.maxAbs == 0.0 || metrics.cosine >= 1.0 - Config::EPSILON;
+
+    // QUANTIZED reads int8 inputs and weights (the output is still fp32) at the int8 MAC peak
+    const bool int8 = infType == Layer::InfType::QUANTIZED;
+    const double ops = 2.0 * c.layer->getMacs();
+    const double bytes = int8 ? static_cast<double>(c.input->getParams().flat_count() +
+                                                    c.layer->getWeightBytes() / sizeof(fp32) +
+                                                    c.layer->getOutputParams().byte_size())
+                              : static_cast<double>(c.input->getParams().byte_size() + c.layer->getWeightBytes() +
+                                                    c.layer->getOutputParams().byte_size());
+    const double peak = int8 ? roof.int8Gops : roof.gflops;
+    const double seconds = r.p50Ms / 1000.0;
+    r.gops = ops / seconds / 1e9;
+    r.gbps = bytes / seconds / 1e9;
+    const double boundSeconds = std::max(ops / (peak * threads * 1e9), bytes / (roof.gbps * 1e9));
+    r.roofPct = 100.0 * boundSeconds / seconds;
+    return r;
+}
+
+// Random fp32 tensor saved where a layer will load it from
+void writeRandom(const LayerParams& params, std::mt19937& rng, float scale) {
+    LayerData data(params);
+    data.allocData();
+    std::uniform_real_distribution<float> dist(-scale, scale);
+    fp32* values = static_cast<fp32*>(data.raw());
+    for (std::size_t i = 0; i < params.flat_count(); i++) values[i] = dist(rng);
+    data.saveData();
+}
+
+// Shapes the toy model does not cover: wider/deeper convs, a 1x1 conv, a weight-bound dense
+// layer, a small classifier head and a large pool
+// (inputs in [0, 1): the convs quantize them with Si = 255, zi = -128 instead of the toy
+// model's calibration file)
+void addSyntheticLayers(Model& model, const Path& dir, std::mt19937& rng) {
+    struct ConvShape {
+        std::size_t h, w, c, k, m;
+    };
+    const ConvShape convs[] = {{32, 32, 16, 3, 32}, {16, 16, 128, 3, 128}, {28, 28, 64, 1, 64}};
+    for (const ConvShape& s : convs) {
+        const std::string id = "conv" + std::to_string(model.getNumLayers());
+        const LayerParams weights{sizeof(fp32), {s.k, s.k, s.c, s.m}, dir / (id + "_weights.bin")};
+        const LayerParams bias{sizeof(fp32), {s.m}, dir / (id + "_biases.bin")};
+        writeRandom(weights, rng, 0.1f);
+        writeRandom(bias, rng, 0.1f);
+        model.addLayer<ConvolutionalLayer>(LayerParams{sizeof(fp32), {s.h, s.w, s.c}},
+                                           LayerParams{sizeof(fp32), {s.h - s.k + 1, s.w - s.k + 1, s.m}}, weights,
+                                           bias);
+        static_cast<ConvolutionalLayer&>(model[model.getNumLayers() - 1]).setInputQuantization(255.0f, -128, 0.0f);
+    }
+
+    const std::size_t denses[][2] = {{4096, 1024}, {1024, 10}};
+    for (const auto& s : denses) {
+        const std::string id = "dense" + std::to_string(model.getNumLayers());
+        const LayerParams weights{sizeof(fp32), {s[0], s[1]}, dir / (id + "_weights.bin")};
+        const LayerParams bias{sizeof(fp32), {s[1]}, dir / (id + "_biases.bin")};
+        writeRandom(weights, rng, 0.05f);
+        writeRandom(bias, rng, 0.05f);
+        model.addLayer<DenseLayer>(LayerParams{sizeof(fp32), {s[0]}}, LayerParams{sizeof(fp32), {s[1]}}, weights,
+                                   bias);
+    }
+
+    model.addLayer<MaxPoolingLayer>(LayerParams{sizeof(fp32), {112, 112, 32}}, LayerParams{sizeof(fp32), {56, 56, 32}},
+                                    LayerParams{sizeof(fp32), {2, 2}});
+}
+
+std::map<std::string, double> loadBaseline(const std::string& path) {
+    std::map<std::string, double> p50;
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Could not read baseline " + path);
+    std::string line;
+    std::getline(in, line);  // Header
+    while (std::getline(in, line)) {
+        const std::vector<std::string> cols = splitList(line);
+        if (cols.size() < 7) continue;
+        p50[cols[0] + "|" + cols[2] + "|" + cols[3]] = std::atof(cols[6].c_str());
+    }
+    return p50;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options opt = parseOptions(argc, argv);
+        setLogLevel(LogLevel::Warn);  // Kernel chatter would land inside the timed runs
+
+        const Roofline roof = measureRoofline();
+        std::cout << std::fixed << std::setprecision(2) << "Roofline (1 thread): " << roof.gflops << " GFLOP/s fp32, "
+                  << roof.int8Gops << " GOP/s int8, " << roof.gbps << " GB/s copy bandwidth\n";
+
+        // Layer-specific calibration: each toy conv is placed in the call-order chain by
+        // BenchCase::convIndex, and the dense layers quantize with their runtime input range
+        // (the "_input" stats of the image would map every deeper activation to a few codes)
+        setCalibrationMode(true);
+        setDenseCalibrationMode(true);
+
+        std::vector<BenchCase> cases;
+        std::vector<std::unique_ptr<LayerData>> inputs;  // Layer inputs and NAIVE outputs
+        Model toy;
+        Model synthetic;
+
+        if (opt.toy) {
+            toy = buildToyModel(opt.dataDir / "model");
+            toy.allocLayers();
+            inputs.emplace_back(new LayerData(toy[0].getInputParams(), opt.dataDir / "image_0.bin"));
+            inputs.back()->loadData();
+            int convs = 0;
+            for (std::size_t i = 0; i < toy.getNumLayers(); i++) {
+                const Layer& layer = toy[i];
+                const LayerData* input = inputs.back().get();
+                // The NAIVE output is both the reference and the next layer's input
+                layer.compute(*input, Layer::InfType::NAIVE);
+                inputs.emplace_back(new LayerData(layer.getOutputData()));
+                const bool conv = dynamic_cast<const ConvolutionalLayer*>(&layer) != nullptr;
+                cases.push_back(BenchCase{"L" + std::to_string(i + 1) + " " + layerKindName(&layer),
+                                          dimsString(layer.getInputParams().dims) + " -> " +
+                                              dimsString(layer.getOutputParams().dims),
+                                          &layer, input, inputs.back().get(), conv ? convs++ : -1});
+            }
+        }
+
+        if (opt.synthetic) {
+            const Path dir = "build/bench_data";
+            mkdir("build", 0755);
+            mkdir(dir.c_str(), 0755);
+            std::mt19937 rng(487);
+            addSyntheticLayers(synthetic, dir, rng);
+            synthetic.allocLayers();
+            std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+            for (std::size_t i = 0; i < synthetic.getNumLayers(); i++) {
+                const Layer& layer = synthetic[i];
+                inputs.emplace_back(new LayerData(layer.getInputParams()));
+                inputs.back()->allocData();
+                fp32* values = static_cast<fp32*>(inputs.back()->raw());
+                for (std::size_t j = 0; j < layer.getInputParams().flat_count(); j++) values[j] = dist(rng);
+                const LayerData* input = inputs.back().get();
+                layer.compute(*input, Layer::InfType::NAIVE);
+                inputs.emplace_back(new LayerData(layer.getOutputData()));
+                cases.push_back(BenchCase{"S" + std::to_string(i + 1) + " " + layerKindName(&layer),
+                                          dimsString(layer.getInputParams().dims) + " -> " +
+                                              dimsString(layer.getOutputParams().dims),
+                                          &layer, input, inputs.back().get(), -1});
+            }
+        }
+
+        std::cout << "Cases: " << cases.size() << ", " << opt.warmup << " warmup + " << opt.reps
+                  << " timed runs each\n\n";
+        std::cout << std::left << std::setw(12) << "layer" << std::setw(28) << "shape" << std::setw(11) << "type"
+                  << std::right << std::setw(4) << "thr" << std::setw(10) << "min ms" << std::setw(10) << "p50 ms"
+                  << std::setw(10) << "p90 ms" << std::setw(10) << "mean ms" << std::setw(9) << "GOPS"
+                  << std::setw(9) << "GB/s" << std::setw(8) << "roof%" << std::setw(11) << "cosine" << "\n";
+
+        std::vector<Result> results;
+        for (const BenchCase& c : cases) {
+            for (Layer::InfType type : opt.types) {
+                // Only the THREADED kernels split work over the shared pool
+                const std::vector<std::size_t> sweep =
+                    type == Layer::InfType::THREADED ? opt.threads : std::vector<std::size_t>{1};
+                for (std::size_t threads : sweep) {
+                    if (type == Layer::InfType::THREADED) ThreadPool::setSharedThreads(threads);
+                    const Result r = runCase(c, type, threads, opt, roof);
+                    results.push_back(r);
+                    std::cout << std::left << std::setw(12) << r.name << std::setw(28) << r.shape << std::setw(11)
+                              << Profiler::infTypeName(r.infType) << std::right << std::setw(4) << r.threads
+                              << std::setprecision(3) << std::setw(10) << r.minMs << std::setw(10) << r.p50Ms
+                              << std::setw(10) << r.p90Ms << std::setw(10) << r.meanMs << std::setprecision(2)
+                              << std::setw(9) << r.gops << std::setw(9) << r.gbps << std::setprecision(1)
+                              << std::setw(8) << r.roofPct << std::setprecision(6) << std::setw(11) << r.cosine
+                              << (r.accurate ? "" : "  drifts from NAIVE") << "\n";
+                }
+            }
+        }
+        ThreadPool::setSharedThreads(0);
+
+        // Default kernel per shape: lowest p50 among the types that match NAIVE, with its
+        // speedup over NAIVE when that ran and the faster types that were rejected
+        std::cout << "\nFastest type per shape\n";
+        for (const BenchCase& c : cases) {
+            const Result* best = nullptr;
+            const Result* naive = nullptr;
+            for (const Result& r : results) {
+                if (r.name != c.name) continue;
+                if (r.accurate && (!best || r.p50Ms < best->p50Ms)) best = &r;
+                if (r.infType == Layer::InfType::NAIVE) naive = &r;
+            }
+            if (!best) continue;
+            std::cout << std::left << std::setw(12) << c.name << std::setw(28) << c.shape << std::setw(11)
+                      << Profiler::infTypeName(best->infType) << std::right << std::setprecision(3) << std::setw(10)
+                      << best->p50Ms << " ms";
+            if (naive) std::cout << std::setprecision(2) << std::setw(8) << naive->p50Ms / best->p50Ms << "x vs NAIVE";
+            for (const Result& r : results) {
+                if (r.name == c.name && !r.accurate && r.p50Ms < best->p50Ms) {
+                    std::cout << "  (" << Profiler::infTypeName(r.infType) << " faster but drifts)";
+                }
+            }
+            std::cout << "\n";
+        }
+
+        if (!opt.csvPath.empty()) {
+            std::ofstream out(opt.csvPath);
+            out << "name,shape,type,threads,min_ms,mean_ms,p50_ms,p90_ms,gops,gbps,roofline_pct,cosine\n";
+            for (const Result& r : results) {
+                out << r.name << "," << r.shape << "," << Profiler::infTypeName(r.infType) << "," << r.threads << ","
+                    << r.minMs << "," << r.meanMs << "," << r.p50Ms << "," << r.p90Ms << "," << r.gops << ","
+                    << r.gbps << "," << r.roofPct << "," << r.cosine << "\n";
+            }
+            if (!out) throw std::runtime_error("Could not write " + opt.csvPath);
+            std::cout << "\nWrote " << opt.csvPath << "\n";
+        }
+
+        if (!opt.baselinePath.empty()) {
+            const std::map<std::string, double> baseline = loadBaseline(opt.baselinePath);
+            std::size_t regressions = 0;
+            for (const Result& r : results) {
+                const auto it = baseline.find(r.name + "|" + Profiler::infTypeName(r.infType) + "|" +
+                                              std::to_string(r.threads));
+                if (it == baseline.end() || it->second <= 0.0) continue;
+                const double ratio = r.p50Ms / it->second;
+                if (ratio > 1.0 + opt.tolerance) {
+                    std::cout << "REGRESSION " << r.name << " " << Profiler::infTypeName(r.infType) << " x"
+                              << r.threads << ": p50 " << std::setprecision(3) << it->second << " -> " << r.p50Ms
+                              << " ms (+" << std::setprecision(1) << 100.0 * (ratio - 1.0) << "%)\n";
+                    regressions++;
+                }
+            }
+            std::cout << "\nBaseline " << opt.baselinePath << ": " << regressions << " regression(s) over "
+                      << std::setprecision(0) << 100.0 * opt.tolerance << "%\n";
+            if (regressions) return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
@@ -12,6 +12,7 @@ if ($Help) {
     Write-Host "  index_generator        Build and run test_index_generator"
     Write_Host "  accelerator_model      Build and run test_accelerator_model"
     Write-Host "  complete_pipeline      Build and run test_complete_pipeline"
+    Write-Host "  layer_engine           Build and run test_layer_engine"
     Write-Host ""
     Write-Host "Options:"
     Write-Host "  -Clean                 Clean build directory before building"
@@ -115,7 +116,37 @@ elseif ($Test -eq "complete_pipeline") {
         exit 1
     }
 }
+# Test 4: layer_engine
+elseif ($Test -eq "layer_engine") {
+    Write-Host "Compiling layer_engine test..." -ForegroundColor Cyan
+    
+    $sourceFiles = @(
+        "$TestsDir\test_layer_engine.cpp",
+        "$TestsDir\LayerEngine.cpp",
+        "$TestsDir\IndexGenerator.cpp",
+        "$TestsDir\StagedMAC.cpp",
+        "$TestsDir\Dequantization.cpp",
+        "$TestsDir\OutputStorage.cpp"
+    )
+    
+    $output = "$BuildDir\test_layer_engine.exe"
+    
+    & g++ -std=c++11 -Wall -O2 -I$SrcDir -I$TestsDir @sourceFiles -o $output
+    
+    if ($LASTEXITCODE -eq 0) {
+        Write-Host "`nCompiled successfully" -ForegroundColor Green
+        Write-Host "`nRunning test..." -ForegroundColor Cyan
+        Write-Host "========================================" -ForegroundColor Gray
+        & $output
+        Write-Host "========================================" -ForegroundColor Gray
+        Write-Host "`nTest complete" -ForegroundColor Green
+    }
+    else {
+        Write-Host " Compilation failed" -ForegroundColor Red
+        exit 1
+    }
+}
 else {
     Write-Host "Unknown test: $Test" -ForegroundColor Red
-    Write-Host "Available tests: index_generator, accelerator_model, complete_pipeline"
+    Write-Host "Available tests: index_generator, accelerator_model, complete_pipeline, layer_engine"
 }
@@ -0,0 +1,176 @@
+#include "AutoTuner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include "Config.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+
+namespace ML {
+
+namespace {
+
+struct CacheEntry {
+    Layer::InfType infType;
+    double ms;
+};
+
+using TuneCache = std::map<std::string, CacheEntry>;
+
+const Layer::InfType ALL_TYPES[] = {Layer::InfType::NAIVE,     Layer::InfType::THREADED,    Layer::InfType::TILED,
+                                    Layer::InfType::SIMD,      Layer::InfType::QUANTIZED,   Layer::InfType::ACCELERATED,
+                                    Layer::InfType::AUTO};
+
+bool parseInfType(const std::string& name, Layer::InfType& infType) {
+    for (Layer::InfType type : ALL_TYPES) {
+        if (name == Profiler::infTypeName(type)) {
+            infType = type;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string dimsString(const std::vector<std::size_t>& dims) {
+    std::string result;
+    for (std::size_t i = 0; i < dims.size(); i++) {
+        result += (i ? "x" : "") + std::to_string(dims[i]);
+    }
+    return result;
+}
+
+// "conv 64x64x3->60x60x32 t4": the kernel choice depends on the shape and the thread count only
+std::string shapeKey(const Layer& layer, std::size_t threads) {
+    return std::string(layerKindName(&layer)) + " " + dimsString(layer.getInputParams().dims) + "->" +
+           dimsString(layer.getOutputParams().dims) + " t" + std::to_string(threads);
+}
+
+// CSV of shape,type,median_ms; a missing file is an empty cache, unreadable rows are skipped
+TuneCache loadCache(const Path& path) {
+    TuneCache cache;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::size_t typeComma = line.find(',');
+        const std::size_t msComma = line.find(',', typeComma + 1);
+        if (typeComma == std::string::npos || msComma == std::string::npos) continue;
+        CacheEntry entry;
+        if (!parseInfType(line.substr(typeComma + 1, msComma - typeComma - 1), entry.infType)) continue;  // Header
+        std::istringstream(line.substr(msComma + 1)) >> entry.ms;
+        cache[line.substr(0, typeComma)] = entry;
+    }
+    return cache;
+}
+
+bool saveCache(const Path& path, const TuneCache& cache) {
+    std::ofstream out(path);
+    if (!out) {
+        logError("Could not write the auto-tune cache to " + path);
+        return false;
+    }
+    out << "shape,type,median_ms\n";
+    for (const TuneCache::value_type& entry : cache) {
+        out << entry.first << "," << Profiler::infTypeName(entry.second.infType) << "," << entry.second.ms << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+// Median wall time of one layer run in ms
+double medianMs(const Layer& layer, const LayerData& input, Layer::InfType infType, const TuneOptions& options) {
+    for (std::size_t i = 0; i < options.warmup; i++) {
+        layer.compute(input, infType);
+    }
+    std::vector<double> times(std::max<std::size_t>(1, options.reps));
+    for (double& ms : times) {
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        layer.compute(input, infType);
+        ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+}  // namespace
+
+std::string TuneReport::summary() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "Auto-tune: " << choices.size() << " layers, " << timed << " timed, " << choices.size() - timed
+        << " from cache (" << seconds << " s)";
+    for (const TuneChoice& choice : choices) {
+        oss << "\n  L" << choice.layer << " " << choice.shape << ": " << Profiler::infTypeName(choice.infType) << " "
+            << choice.ms << " ms" << (choice.cached ? " (cached)" : "");
+    }
+    return oss.str();
+}
+
+TuneReport autoTune(Model& model, const LayerData& sample, const TuneOptions& options) {
+    if (options.candidates.empty()) {
+        throw std::runtime_error("autoTune needs at least one candidate inference type");
+    }
+    for (Layer::InfType type : options.candidates) {
+        if (type == Layer::InfType::QUANTIZED || type == Layer::InfType::ACCELERATED || type == Layer::InfType::AUTO) {
+            throw std::runtime_error(std::string("autoTune: ") + Profiler::infTypeName(type) + " cannot be a candidate");
+        }
+    }
+
+    // Cached shapes of other models are kept when the file is rewritten
+    TuneCache cache = options.cachePath.empty() ? TuneCache() : loadCache(options.cachePath);
+    const std::size_t threads = ThreadPool::shared().size();
+
+    TuneReport report;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    std::unique_ptr<LayerData> input(new LayerData(sample));  // NAIVE activations into the current layer
+    for (std::size_t i = 0; i < model.getNumLayers(); i++) {
+        Layer& layer = model[i];
+        layer.compute(*input, Layer::InfType::NAIVE);
+        std::unique_ptr<LayerData> reference(new LayerData(layer.getOutputData()));
+
+        TuneChoice choice{i, shapeKey(layer, threads), Layer::InfType::NAIVE, 0.0, false};
+        const TuneCache::const_iterator cached = cache.find(choice.shape);
+        if (!options.retune && cached != cache.end() &&
+            std::find(options.candidates.begin(), options.candidates.end(), cached->second.infType) !=
+                options.candidates.end()) {
+            choice.infType = cached->second.infType;
+            choice.ms = cached->second.ms;
+            choice.cached = true;
+        } else {
+            bool found = false;
+            for (Layer::InfType type : options.candidates) {
+                const double ms = medianMs(layer, *input, type, options);
+                const CompareMetrics metrics = layer.getOutputData().compareMetrics<fp32>(*reference);
+                if (metrics.maxAbs > 0.0 && metrics.cosine < 1.0 - Config::EPSILON) {
+                    ML_LOG_WARN(std::string("Auto-tune: ") + Profiler::infTypeName(type) + " output of L" +
+                                std::to_string(i) + " differs from NAIVE, skipped");
+                    continue;
+                }
+                if (!found || ms < choice.ms) {
+                    choice.infType = type;
+                    choice.ms = ms;
+                    found = true;
+                }
+            }
+            cache[choice.shape] = CacheEntry{choice.infType, choice.ms};
+            report.timed++;
+        }
+
+        layer.setTunedType(choice.infType);
+        report.choices.push_back(choice);
+        input = std::move(reference);
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if (report.timed && !options.cachePath.empty()) {
+        saveCache(options.cachePath, cache);
+    }
+    return report;
+}
+
+}  // namespace ML
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Model.h"
+#include "Utils.h"
+
+namespace ML {
+
+// Per-layer kernel selection: time each candidate inference type on every layer of a model,
+// keep the fastest and let Layer::InfType::AUTO dispatch to it. Winners are keyed by layer
+// kind, input/output shape and thread count, and persisted to a CSV cache so later runs on
+// the same machine skip the timing.
+struct TuneOptions {
+    Path cachePath = "build/autotune_cache.csv";  // "" = no cache
+    // fp32 types only: the int8 kernels pick calibration stats from global call-order
+    // counters, so they cannot be mixed per layer
+    std::vector<Layer::InfType> candidates = {Layer::InfType::NAIVE, Layer::InfType::THREADED, Layer::InfType::TILED,
+                                              Layer::InfType::SIMD};
+    std::size_t warmup = 1;  // Untimed runs per candidate
+    std::size_t reps = 5;    // Timed runs per candidate; the median counts
+    bool retune = false;     // Time every layer even if cached (the cache is rewritten)
+};
+
+struct TuneChoice {
+    std::size_t layer;
+    std::string shape;  // Cache key, "conv 64x64x3->60x60x32 t1"
+    Layer::InfType infType;
+    double ms;          // Median of the winner (as measured when it was cached)
+    bool cached;
+};
+
+struct TuneReport {
+    std::vector<TuneChoice> choices;  // One per model layer
+    std::size_t timed = 0;            // Layers timed in this run (the rest came from the cache)
+    double seconds = 0.0;
+
+    // One line per layer for logInfo
+    std::string summary() const;
+};
+
+// Tune every layer of the model on one sample input (layer buffers must be allocated).
+// Each layer is timed on the NAIVE output of the layers before it, and a candidate whose
+// output drifts from NAIVE (cosine below 1 - Config::EPSILON) is discarded.
+TuneReport autoTune(Model& model, const LayerData& sample, const TuneOptions& options = TuneOptions());
+
+}  // namespace ML
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+#ifndef ZEDBOARD
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#endif
+
+namespace ML {
+
+#ifndef ZEDBOARD
+// Bounded FIFO between a producer and a consumer thread (pipeline stages, image prefetch).
+// close() ends the stream after the queued items; abort() wakes everyone up and drops the
+// rest (one side failed).
+template <typename T> class BoundedQueue {
+   public:
+    explicit BoundedQueue(std::size_t capacity) : capacity(capacity) {}
+
+    // Blocks while full; false if the queue was aborted
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return aborted || items.size() < capacity; });
+        if (aborted) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Blocks while empty; false once closed and drained, or aborted
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return aborted || closed || !items.empty(); });
+        if (aborted || items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+    void abort() {
+        std::lock_guard<std::mutex> lock(mutex);
+        aborted = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+   private:
+    std::size_t capacity;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    bool closed = false;
+    bool aborted = false;
+};
+#endif
+
+}  // namespace ML
@@ -0,0 +1,105 @@
+#include "BufferPool.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace ML {
+
+#ifndef ZEDBOARD
+#define POOL_LOCK() std::lock_guard<std::mutex> lock(mutex)
+#else
+#define POOL_LOCK() ((void)0)
+#endif
+
+BufferPool::BufferPool(std::size_t maxCachedBytes) : maxCached(maxCachedBytes), counters() {}
+
+BufferPool::~BufferPool() { trim(); }
+
+BufferPool& BufferPool::shared() {
+    // Never destroyed: LayerData in static storage may release after other statics are gone
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+std::size_t BufferPool::sizeClass(std::size_t bytes) {
+    if (bytes <= 4 * ALIGNMENT) {
+        return bytes == 0 ? ALIGNMENT : (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+    // Largest power of two below bytes, split into 4 steps (at most 25% slack)
+    std::size_t power = 4 * ALIGNMENT;
+    while (power * 2 < bytes) {
+        power *= 2;
+    }
+    const std::size_t step = power / 4;
+    return (bytes + step - 1) / step * step;
+}
+
+// Over-allocate and keep the heap pointer just below the aligned block
+void* BufferPool::alignedAlloc(std::size_t bytes) {
+    void* raw = std::malloc(bytes + ALIGNMENT + sizeof(void*));
+    if (!raw) {
+        throw std::bad_alloc();
+    }
+    std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + ALIGNMENT - 1) &
+                             ~static_cast<std::uintptr_t>(ALIGNMENT - 1);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void BufferPool::alignedFree(void* ptr) {
+    std::free(static_cast<void**>(ptr)[-1]);
+}
+
+void* BufferPool::allocate(std::size_t bytes) {
+    const std::size_t cls = sizeClass(bytes);
+    {
+        POOL_LOCK();
+        counters.allocations++;
+        auto it = freeLists.find(cls);
+        if (it != freeLists.end() && !it->second.empty()) {
+            void* ptr = it->second.back();
+            it->second.pop_back();
+            counters.reused++;
+            counters.bytesCached -= cls;
+            return ptr;
+        }
+    }
+    return alignedAlloc(cls);
+}
+
+void BufferPool::release(void* ptr, std::size_t bytes) {
+    if (!ptr) {
+        return;
+    }
+    const std::size_t cls = sizeClass(bytes);
+    {
+        POOL_LOCK();
+        if (counters.bytesCached + cls <= maxCached) {
+            freeLists[cls].push_back(ptr);
+            counters.bytesCached += cls;
+            return;
+        }
+    }
+    alignedFree(ptr);
+}
+
+void BufferPool::trim() {
+    POOL_LOCK();
+    for (auto& list : freeLists) {
+        for (void* ptr : list.second) {
+            alignedFree(ptr);
+        }
+    }
+    freeLists.clear();
+    counters.bytesCached = 0;
+}
+
+BufferPool::Stats BufferPool::stats() const {
+    POOL_LOCK();
+    return counters;
+}
+
+#undef POOL_LOCK
+
+}  // namespace ML
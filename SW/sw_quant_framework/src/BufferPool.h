@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#ifndef ZEDBOARD
+#include <mutex>
+#endif
+
+namespace ML {
+
+// Cache-line (64-byte) aligned buffers recycled through size-class free lists
+// Used for all LayerData storage and for per-inference scratch vectors, so repeated
+// alloc/free of the same shapes (model reloads, quantized input buffers) reuses memory
+// and every buffer starts on its own cache line for aligned SIMD loads.
+class BufferPool {
+   public:
+    static const std::size_t ALIGNMENT = 64;
+
+    struct Stats {
+        std::size_t allocations;   // allocate() calls
+        std::size_t reused;        // ... served from a free list
+        std::size_t bytesCached;   // Bytes currently parked in free lists
+    };
+
+    // Free lists keep at most this many bytes; larger releases go back to the heap
+    explicit BufferPool(std::size_t maxCachedBytes = 256u << 20);
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Process-wide pool
+    static BufferPool& shared();
+
+    // 64-byte aligned block of at least `bytes` bytes (never null, throws std::bad_alloc)
+    void* allocate(std::size_t bytes);
+
+    // Return a block from allocate(); `bytes` must be the size it was requested with
+    void release(void* ptr, std::size_t bytes);
+
+    // Free every cached block
+    void trim();
+
+    Stats stats() const;
+
+    // Size class a request is rounded up to (4 classes per power of two, multiples of 64)
+    static std::size_t sizeClass(std::size_t bytes);
+
+   private:
+    static void* alignedAlloc(std::size_t bytes);
+    static void alignedFree(void* ptr);
+
+    std::map<std::size_t, std::vector<void*>> freeLists;
+    std::size_t maxCached;
+    Stats counters;
+#ifndef ZEDBOARD
+    mutable std::mutex mutex;
+#endif
+};
+
+// std::allocator replacement backed by the shared BufferPool (for scratch vectors)
+template <typename T> struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() {}
+    template <typename U> PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(BufferPool::shared().allocate(n * sizeof(T))); }
+    void deallocate(T* ptr, std::size_t n) { BufferPool::shared().release(ptr, n * sizeof(T)); }
+};
+
+template <typename T, typename U> bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+template <typename T, typename U> bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
+
+// 64-byte aligned, pooled vector (kernel scratch buffers, packed weights)
+template <typename T> using AlignedVector = std::vector<T, PoolAllocator<T>>;
+
+}  // namespace ML
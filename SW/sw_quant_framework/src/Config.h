@@ -10,5 +10,13 @@ constexpr bool FANCY_LOGGING = true;
 
 // Floating Point Compare Epsilon
 constexpr float EPSILON = 0.001;
+
+// Quantized conv/dense layers skip zero activations when fewer than this fraction of the
+// inputs are nonzero (Layer::setSparseDensityThreshold overrides it per layer)
+constexpr float SPARSE_DENSITY_THRESHOLD = 0.75f;
+
+// Conv/dense layers iterate only the nonzero 1 x 16 weight blocks (see BlockSparse.h) when
+// fewer than this fraction of the blocks are kept after pruning
+constexpr float BLOCK_SPARSE_DENSITY_THRESHOLD = 0.75f;
 } // namespace Config
 } // namespace ML::Config
\ No newline at end of file
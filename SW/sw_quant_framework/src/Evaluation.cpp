@@ -0,0 +1,270 @@
+#include "Evaluation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#ifndef ZEDBOARD
+#include <future>
+#include <thread>
+#endif
+
+#include "BoundedQueue.h"
+#include "Profiler.h"
+#include "layers/Convolutional.h"
+#include "layers/Dense.h"
+#include "layers/Softmax.h"
+
+namespace ML {
+
+namespace {
+
+bool isInt8(Layer::InfType infType) {
+    return infType == Layer::InfType::QUANTIZED || infType == Layer::InfType::ACCELERATED;
+}
+
+// Image <index> of the stream, or null past the last one
+std::unique_ptr<LayerData> loadImage(const LayerParams& params, const EvalOptions& options, std::size_t index) {
+    if (options.maxImages && index >= options.maxImages) {
+        return nullptr;
+    }
+    const Path path = options.imageDir / (options.imagePrefix + std::to_string(index) + ".bin");
+    std::unique_ptr<LayerData> image(new LayerData(params, path));
+#ifdef ZEDBOARD
+    // No cheap existence check on the SD card: a missing file ends the stream
+    try {
+        image->loadData();
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+#else
+    if (!std::ifstream(path, std::ios::binary).is_open()) {
+        return nullptr;
+    }
+    image->loadData();  // Read errors of an existing file propagate
+#endif
+    return image;
+}
+
+std::vector<int> loadLabels(const Path& path) {
+    std::vector<int> labels;
+    if (path.empty()) {
+        return labels;
+    }
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open labels file: " + path);
+    }
+    int label;
+    while (in >> label) {
+        labels.push_back(label);
+    }
+    return labels;
+}
+
+bool inTopK(const std::vector<SoftmaxLayer::ClassScore>& topK, std::size_t index) {
+    for (const SoftmaxLayer::ClassScore& cls : topK) {
+        if (cls.index == index) return true;
+    }
+    return false;
+}
+
+// Running totals of evaluateBatch, turned into a report at the end
+struct EvalTotals {
+    std::size_t images = 0;
+    std::size_t top1Matches = 0, top5Matches = 0, top5Overlap = 0;
+    double klSum = 0.0, klMax = 0.0;
+    std::size_t labelled = 0;
+    std::size_t referenceTop1 = 0, referenceTop5 = 0, testTop1 = 0, testTop5 = 0;
+    double referenceMs = 0.0, testMs = 0.0;
+
+    void add(const std::vector<fp32>& p, const std::vector<fp32>& q, int label) {
+        const std::vector<SoftmaxLayer::ClassScore> refTop = SoftmaxLayer::topK(p.data(), p.size(), 5);
+        const std::vector<SoftmaxLayer::ClassScore> testTop = SoftmaxLayer::topK(q.data(), q.size(), 5);
+        images++;
+        top1Matches += refTop[0].index == testTop[0].index;
+        top5Matches += inTopK(testTop, refTop[0].index);
+        for (const SoftmaxLayer::ClassScore& cls : refTop) {
+            top5Overlap += inTopK(testTop, cls.index);
+        }
+
+        const double kl = klDivergence(p, q);
+        klSum += kl;
+        klMax = std::max(klMax, kl);
+
+        if (label >= 0) {
+            const std::size_t truth = static_cast<std::size_t>(label);
+            labelled++;
+            referenceTop1 += refTop[0].index == truth;
+            referenceTop5 += inTopK(refTop, truth);
+            testTop1 += testTop[0].index == truth;
+            testTop5 += inTopK(testTop, truth);
+        }
+    }
+
+    EvalReport report(double seconds) const {
+        EvalReport r;
+        r.images = images;
+        r.labelled = labelled;
+        r.seconds = seconds;
+        if (images) {
+            r.top1Agreement = 100.0 * top1Matches / images;
+            r.top5Agreement = 100.0 * top5Matches / images;
+            r.meanTop5Overlap = static_cast<double>(top5Overlap) / images;
+            r.meanKL = klSum / images;
+            r.maxKL = klMax;
+            r.referenceMs = referenceMs / images;
+            r.testMs = testMs / images;
+            r.imagesPerSecond = seconds > 0.0 ? images / seconds : 0.0;
+        }
+        if (labelled) {
+            r.referenceTop1 = 100.0 * referenceTop1 / labelled;
+            r.referenceTop5 = 100.0 * referenceTop5 / labelled;
+            r.testTop1 = 100.0 * testTop1 / labelled;
+            r.testTop5 = 100.0 * testTop5 / labelled;
+        }
+        return r;
+    }
+};
+
+double runTimed(const Model& model, const LayerData& image, Layer::InfType infType) {
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    model.inference(image, infType);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+}  // namespace
+
+std::vector<fp32> classProbabilities(const Model& model, const LayerData& output) {
+    const TensorView<const fp32> values = output.view<fp32>();
+    std::vector<fp32> probs(values.data(), values.data() + values.size());
+    const SoftmaxLayer* softmax = dynamic_cast<const SoftmaxLayer*>(&model.getOutputLayer());
+    if (!softmax || softmax->getOutputMode() != SoftmaxLayer::OutputMode::PROBABILITIES) {
+        SoftmaxLayer::softmax(values.data(), probs.data(), values.size());
+    }
+    return probs;
+}
+
+double klDivergence(const std::vector<fp32>& p, const std::vector<fp32>& q) {
+    double kl = 0.0;
+    for (std::size_t i = 0; i < p.size(); i++) {
+        if (p[i] > 0.0f) kl += p[i] * std::log(p[i] / std::max(q[i], 1e-12f));
+    }
+    return kl;
+}
+
+std::string EvalReport::summary() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "Batch evaluation: " << images << " images in " << seconds << " s (" << imagesPerSecond
+        << " images/s; reference " << referenceMs << " ms, test " << testMs << " ms per image)\n";
+    oss << "  Top-1 agreement: " << top1Agreement << "%, top-5 agreement: " << top5Agreement
+        << "%, top-5 overlap: " << meanTop5Overlap << "/5\n";
+    oss << std::setprecision(6) << "  KL-divergence: mean " << meanKL << ", max " << maxKL;
+    if (labelled) {
+        oss << std::setprecision(2) << "\n  Ground truth (" << labelled << " labelled): reference top-1 "
+            << referenceTop1 << "% / top-5 " << referenceTop5 << "%, test top-1 " << testTop1 << "% / top-5 "
+            << testTop5 << "%";
+    }
+    return oss.str();
+}
+
+EvalReport evaluateBatch(const Model& reference, const Model& test, const EvalOptions& options) {
+    if (&reference == &test) {
+        throw std::runtime_error("evaluateBatch needs two model instances");
+    }
+    if (isInt8(options.referenceType)) {
+        throw std::runtime_error("evaluateBatch: only the test inference type may be quantized");
+    }
+    logInfo(std::string("Evaluating ") + Profiler::infTypeName(options.testType) + " against " +
+            Profiler::infTypeName(options.referenceType) + " on " + options.imageDir / (options.imagePrefix + "*.bin"));
+
+    const std::vector<int> labels = loadLabels(options.labelsPath);
+    const LayerParams& inParams = reference[0].getInputParams();
+    if (isInt8(options.testType)) {
+        setCalibrationMode(true);
+        setDenseCalibrationMode(true);
+    }
+
+    EvalTotals totals;
+    auto evaluate = [&](const LayerData& image) {
+        // The reference runs on its own thread while the caller runs the test model
+        auto runTest = [&]() {
+            if (isInt8(options.testType)) {
+                resetConvLayerCounter();
+                resetDenseLayerCounter();
+            }
+            return runTimed(test, image, options.testType);
+        };
+#ifndef ZEDBOARD
+        std::future<double> referenceRun =
+            std::async(std::launch::async, runTimed, std::cref(reference), std::cref(image), options.referenceType);
+        totals.testMs += runTest();
+        totals.referenceMs += referenceRun.get();
+#else
+        totals.referenceMs += runTimed(reference, image, options.referenceType);
+        totals.testMs += runTest();
+#endif
+        const std::size_t index = totals.images;
+        totals.add(classProbabilities(reference, reference.getOutputLayer().getOutputData()),
+                   classProbabilities(test, test.getOutputLayer().getOutputData()),
+                   index < labels.size() ? labels[index] : -1);
+    };
+
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+#ifndef ZEDBOARD
+    // Reader thread: loads images ahead into a bounded queue
+    BoundedQueue<std::unique_ptr<LayerData>> queue(std::max<std::size_t>(1, options.prefetch));
+    std::exception_ptr readError;
+    std::thread reader([&]() {
+        try {
+            for (std::size_t i = 0;; i++) {
+                std::unique_ptr<LayerData> image = loadImage(inParams, options, i);
+                if (!image || !queue.push(std::move(image))) break;
+            }
+        } catch (...) {
+            readError = std::current_exception();
+        }
+        queue.close();
+    });
+    try {
+        std::unique_ptr<LayerData> image;
+        while (queue.pop(image)) {
+            evaluate(*image);
+        }
+    } catch (...) {
+        queue.abort();
+        reader.join();
+        throw;
+    }
+    reader.join();
+    if (readError) {
+        std::rethrow_exception(readError);
+    }
+#else
+    for (std::size_t i = 0;; i++) {
+        std::unique_ptr<LayerData> image = loadImage(inParams, options, i);
+        if (!image) break;
+        evaluate(*image);
+    }
+#endif
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if (!totals.images) {
+        logError("No images found at " + options.imageDir / (options.imagePrefix + "0.bin"));
+    }
+    if (!labels.empty() && labels.size() != totals.images) {
+        ML_LOG_WARN("Labels file has " + std::to_string(labels.size()) + " entries for " +
+                    std::to_string(totals.images) + " images");
+    }
+    return totals.report(seconds);
+}
+
+}  // namespace ML
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Model.h"
+#include "Utils.h"
+
+namespace ML {
+
+// Batch evaluation of one inference type against another over a stream of images
+struct EvalOptions {
+    Path imageDir = "data";
+    std::string imagePrefix = "image_";  // Images are <imageDir>/<prefix>0.bin, <prefix>1.bin, ... until one is missing
+    std::size_t maxImages = 0;           // 0 = every image found
+    std::size_t prefetch = 4;            // Images loaded ahead by the background reader
+    Path labelsPath = "";                // Optional ground truth: one class index per line, in image order
+    Layer::InfType referenceType = Layer::InfType::NAIVE;
+    Layer::InfType testType = Layer::InfType::QUANTIZED;
+};
+
+struct EvalReport {
+    std::size_t images = 0;
+
+    // Test vs reference
+    double top1Agreement = 0.0;  // % of images with the same top-1 class
+    double top5Agreement = 0.0;  // % of images whose reference top-1 is in the test top-5
+    double meanTop5Overlap = 0.0;  // Classes shared by the two top-5 lists, 0..5
+    double meanKL = 0.0;         // KL(reference || test) of the class probabilities
+    double maxKL = 0.0;
+
+    // Against the labels (labelled = 0 without a labels file)
+    std::size_t labelled = 0;
+    double referenceTop1 = 0.0, referenceTop5 = 0.0;  // Accuracy in %
+    double testTop1 = 0.0, testTop5 = 0.0;
+
+    // Throughput
+    double seconds = 0.0;        // Wall time of the whole batch
+    double imagesPerSecond = 0.0;
+    double referenceMs = 0.0;    // Mean inference time per image
+    double testMs = 0.0;
+
+    // Multi-line summary for logInfo
+    std::string summary() const;
+};
+
+// Class probabilities of a model output: a softmax layer in PROBABILITIES mode already wrote
+// them; otherwise (logits, TOP_K mode) normalize here
+std::vector<fp32> classProbabilities(const Model& model, const LayerData& output);
+
+// KL(p || q) of two class probability vectors
+double klDivergence(const std::vector<fp32>& p, const std::vector<fp32>& q);
+
+// Stream the images through both models and compare their outputs.
+// A background thread reads the images ahead of inference, and each image runs through the
+// reference and the test model at the same time, so the two must be separate Model
+// instances (layer output buffers are per model). Only the test type may be an int8 type:
+// the quantized kernels pick calibration stats from global call-order counters, which this
+// resets before every test inference. On the ZedBoard everything runs on the caller.
+EvalReport evaluateBatch(const Model& reference, const Model& test, const EvalOptions& options = EvalOptions());
+
+}  // namespace ML
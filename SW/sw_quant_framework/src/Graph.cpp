@@ -0,0 +1,211 @@
+#include "Graph.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+#include "layers/Convolutional.h"
+#include "layers/Dense.h"
+#include "layers/Flatten.h"
+#include "layers/MaxPooling.h"
+#include "layers/Softmax.h"
+#include "layers/Tensor.h"
+
+namespace ML {
+
+const char* layerKindName(const Layer* layer) {
+    if (dynamic_cast<const ConvolutionalLayer*>(layer)) return "conv";
+    if (dynamic_cast<const MaxPoolingLayer*>(layer)) return "pool";
+    if (dynamic_cast<const FlattenLayer*>(layer)) return "flatten";
+    if (dynamic_cast<const DenseLayer*>(layer)) return "dense";
+    if (dynamic_cast<const SoftmaxLayer*>(layer)) return "softmax";
+    return "layer";
+}
+
+std::string GraphNode::name() const {
+    std::string result;
+    for (std::size_t i = 0; i < layers.size(); i++) {
+        result += (i ? "+" : "") + std::string(layerKindName(layers[i]));
+    }
+    return result;
+}
+
+Graph::Graph(const std::vector<Layer*>& layers) : modelLayers(layers) {
+    for (Layer* layer : layers) {
+        nodes.push_back(GraphNode{GraphNode::Op::LAYER, {layer}});
+    }
+}
+
+const std::vector<Graph::NamedPass>& Graph::defaultPasses() {
+    static const std::vector<NamedPass> passes = {
+        {"eliminate-flatten", eliminateFlatten},
+        {"fuse-conv-pool", fuseConvPool},
+        {"fuse-dense-softmax", fuseDenseSoftmax},
+    };
+    return passes;
+}
+
+void Graph::optimize(const std::vector<NamedPass>& passes) {
+    for (const NamedPass& pass : passes) {
+        const std::size_t rewrites = pass.run(nodes);
+        logInfo(std::string("Graph pass ") + pass.name + ": " + std::to_string(rewrites) + " rewrite(s)");
+    }
+    logInfo("Graph: " + describe());
+}
+
+std::string Graph::describe() const {
+    std::string result;
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        result += (i ? " -> " : "") + nodes[i].name();
+    }
+    return result;
+}
+
+// "L1-2 conv+pool": model layer indices and kinds of a node
+std::string Graph::nodeLabel(const GraphNode& node) const {
+    const std::size_t first = std::find(modelLayers.begin(), modelLayers.end(), node.layers.front()) - modelLayers.begin();
+    const std::size_t last = std::find(modelLayers.begin(), modelLayers.end(), node.layers.back()) - modelLayers.begin();
+    return "L" + std::to_string(first) + (last != first ? "-" + std::to_string(last) : "") + " " + node.name();
+}
+
+const LayerData& Graph::run(const LayerData& inData, Layer::InfType infType, Profiler* profiler) const {
+    const LayerData* current = &inData;
+    for (const GraphNode& node : nodes) {
+        if (profiler) {
+            Profiler::Scope scope(profiler, nodeLabel(node), std::vector<const Layer*>(node.layers.begin(), node.layers.end()),
+                                  node.layers[0]->resolveInfType(infType), current->getParams().byte_size());
+            runNode(node, *current, infType);
+        } else {
+            runNode(node, *current, infType);
+        }
+        current = &node.layers.back()->getOutputData();
+        if (node.op == GraphNode::Op::DENSE_SOFTMAX &&
+            static_cast<const SoftmaxLayer*>(node.layers[1])->getOutputMode() == SoftmaxLayer::OutputMode::TOP_K) {
+            current = &node.layers[0]->getOutputData();  // Logits; the softmax output was not written
+        }
+    }
+    return *current;
+}
+
+void Graph::runNode(const GraphNode& node, const LayerData& inData, Layer::InfType infType) {
+    switch (node.op) {
+    case GraphNode::Op::LAYER:
+        node.layers[0]->compute(inData, infType);
+        break;
+
+    case GraphNode::Op::CONV_POOL: {
+        const ConvolutionalLayer& conv = static_cast<const ConvolutionalLayer&>(*node.layers[0]);
+        const MaxPoolingLayer& pool = static_cast<const MaxPoolingLayer&>(*node.layers[1]);
+        const Layer::InfType convType = conv.resolveInfType(infType);  // AUTO: the band schedule follows the conv
+
+        // The int8 paths quantize the whole input up front; run them layer by layer
+        if (convType == Layer::InfType::QUANTIZED || convType == Layer::InfType::ACCELERATED) {
+            conv.compute(inData, infType);
+            pool.compute(conv.getOutputData(), infType);
+            break;
+        }
+
+        // Per pooled row: the conv rows under its windows, pooled while still in cache
+        const std::size_t poolHeight = pool.getPoolParams().dims[0];
+        const Tensor<const fp32, 3> convOut(conv.getOutputData());
+        const Tensor<fp32, 3> poolOut(pool.getOutputData());
+        const bool tiled = convType == Layer::InfType::TILED;  // Winograd tiles on 3x3 convs
+        const bool simd = convType == Layer::InfType::SIMD;    // Pixel-major, block-sparse if pruned
+        auto band = [&](std::size_t first, std::size_t last) {
+            for (std::size_t row = first; row < last; row++) {
+                if (tiled) {
+                    conv.computeTiledRows(inData, row * poolHeight, (row + 1) * poolHeight);
+                } else if (simd) {
+                    conv.computeSIMDRows(inData, row * poolHeight, (row + 1) * poolHeight);
+                } else {
+                    conv.computeRows(inData, row * poolHeight, (row + 1) * poolHeight);
+                }
+                pool.poolRows<fp32>(convOut, poolOut, row, row + 1);
+            }
+        };
+        if (convType == Layer::InfType::THREADED) {
+            ThreadPool::shared().parallelFor(poolOut.dim(0), 1, band);
+        } else {
+            band(0, poolOut.dim(0));
+        }
+        break;
+    }
+
+    case GraphNode::Op::DENSE_SOFTMAX: {
+        const Layer& dense = *node.layers[0];
+        const SoftmaxLayer& softmax = static_cast<const SoftmaxLayer&>(*node.layers[1]);
+        dense.compute(inData, infType);
+        if (softmax.getOutputMode() == SoftmaxLayer::OutputMode::TOP_K) {
+            softmax.rankClasses(dense.getOutputData());  // Labels only: no exp, normalize or copy
+        } else {
+            softmax.compute(dense.getOutputData(), infType);
+        }
+        break;
+    }
+    }
+}
+
+// Pattern helper: node i is a single layer of type T
+template <typename T> static T* singleLayer(const std::vector<GraphNode>& nodes, std::size_t i) {
+    if (i >= nodes.size() || nodes[i].op != GraphNode::Op::LAYER) return nullptr;
+    return dynamic_cast<T*>(nodes[i].layers[0]);
+}
+
+std::size_t eliminateFlatten(std::vector<GraphNode>& nodes) {
+    std::size_t rewrites = 0;
+    for (std::size_t i = 1; i + 1 < nodes.size();) {
+        FlattenLayer* flatten = singleLayer<FlattenLayer>(nodes, i);
+        // Only between two layers, and only a pure reshape (the last node's output is the model's)
+        if (flatten && flatten->getInputParams().flat_count() == flatten->getOutputParams().flat_count() &&
+            flatten->getInputParams().elementSize == flatten->getOutputParams().elementSize) {
+            nodes.erase(nodes.begin() + i);
+            rewrites++;
+        } else {
+            i++;
+        }
+    }
+    return rewrites;
+}
+
+std::size_t fuseConvPool(std::vector<GraphNode>& nodes) {
+    std::size_t rewrites = 0;
+    for (std::size_t i = 0; i + 1 < nodes.size(); i++) {
+        ConvolutionalLayer* conv = singleLayer<ConvolutionalLayer>(nodes, i);
+        MaxPoolingLayer* pool = singleLayer<MaxPoolingLayer>(nodes, i + 1);
+        if (!conv || !pool) continue;
+
+        // Bands of conv rows map 1:1 onto pooled rows only if the windows tile the rows exactly
+        const std::vector<std::size_t>& convOut = conv->getOutputParams().dims;
+        const std::vector<std::size_t>& poolIn = pool->getInputParams().dims;
+        const std::vector<std::size_t>& poolOut = pool->getOutputParams().dims;
+        if (convOut != poolIn || convOut.size() != 3 || poolOut.size() != 3 ||
+            poolOut[0] * pool->getPoolParams().dims[0] != convOut[0]) {
+            continue;
+        }
+
+        nodes[i] = GraphNode{GraphNode::Op::CONV_POOL, {conv, pool}};
+        nodes.erase(nodes.begin() + i + 1);
+        rewrites++;
+    }
+    return rewrites;
+}
+
+std::size_t fuseDenseSoftmax(std::vector<GraphNode>& nodes) {
+    std::size_t rewrites = 0;
+    for (std::size_t i = 0; i + 1 < nodes.size(); i++) {
+        DenseLayer* dense = singleLayer<DenseLayer>(nodes, i);
+        SoftmaxLayer* softmax = singleLayer<SoftmaxLayer>(nodes, i + 1);
+        if (!dense || !softmax ||
+            dense->getOutputParams().flat_count() != softmax->getInputParams().flat_count()) {
+            continue;
+        }
+
+        nodes[i] = GraphNode{GraphNode::Op::DENSE_SOFTMAX, {dense, softmax}};
+        nodes.erase(nodes.begin() + i + 1);
+        rewrites++;
+    }
+    return rewrites;
+}
+
+}  // namespace ML
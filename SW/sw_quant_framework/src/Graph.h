@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "layers/Layer.h"
+
+namespace ML {
+
+class Profiler;
+
+// Short kind name of a layer ("conv", "pool", "flatten", "dense", "softmax")
+const char* layerKindName(const Layer* layer);
+
+// Executable node of a model graph: one layer, or several layers run as one fused step
+struct GraphNode {
+    enum class Op {
+        LAYER,          // Single layer, its own compute function
+        CONV_POOL,      // Conv (+ ReLU) and the max pool reading it, interleaved per band of pooled rows
+        DENSE_SOFTMAX,  // Dense (logits) and softmax; in TOP_K mode the softmax only ranks the logits
+    };
+
+    Op op;
+    std::vector<Layer*> layers;  // Model layers this node runs, in execution order
+
+    std::string name() const;
+};
+
+// Linear graph IR over the model's layers, rewritten by fusion passes before inference.
+// Every node reads the output buffer of the node before it, so a pass may drop a layer
+// whose output is a pure reshape of its input (flatten) or merge neighbouring layers.
+// Outputs of layers inside a fused node may be left stale (e.g. softmax in TOP_K mode).
+class Graph {
+   public:
+    // Rewrite of the node list; returns the number of nodes it changed
+    using Pass = std::size_t (*)(std::vector<GraphNode>& nodes);
+
+    struct NamedPass {
+        const char* name;
+        Pass run;
+    };
+
+    // One LAYER node per layer
+    explicit Graph(const std::vector<Layer*>& layers);
+
+    // Passes run by Model::optimize, in order
+    static const std::vector<NamedPass>& defaultPasses();
+
+    // Run the passes in order, logging what each one rewrote
+    void optimize(const std::vector<NamedPass>& passes = defaultPasses());
+
+    // Run every node; returns the output of the last one. With a profiler, each node is recorded.
+    const LayerData& run(const LayerData& inData, Layer::InfType infType, Profiler* profiler = nullptr) const;
+
+    const std::vector<GraphNode>& getNodes() const { return nodes; }
+
+    // "conv+pool -> conv+pool -> ... -> dense+softmax"
+    std::string describe() const;
+
+   private:
+    std::string nodeLabel(const GraphNode& node) const;
+    static void runNode(const GraphNode& node, const LayerData& inData, Layer::InfType infType);
+
+    std::vector<Layer*> modelLayers;  // Model order, for node labels
+    std::vector<GraphNode> nodes;
+};
+
+// Built-in passes
+// ReLU has no node of its own here: conv and dense apply it in their kernels.
+
+// Drop flatten layers: the next layer reads the (contiguous HWC) input of the flatten directly
+std::size_t eliminateFlatten(std::vector<GraphNode>& nodes);
+
+// Conv followed by a max pool whose windows tile the conv output rows exactly
+std::size_t fuseConvPool(std::vector<GraphNode>& nodes);
+
+// Dense followed by softmax over its output
+std::size_t fuseDenseSoftmax(std::vector<GraphNode>& nodes);
+
+}  // namespace ML
@@ -0,0 +1,135 @@
+#include "MixedPrecision.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "Evaluation.h"
+#include "layers/Convolutional.h"
+#include "layers/Dense.h"
+#include "layers/Int4.h"
+
+namespace ML {
+
+namespace {
+
+// Class probabilities of the model on every calibration image
+std::vector<std::vector<fp32>> classOutputs(const Model& model, const std::vector<LayerData>& images,
+                                            Layer::InfType infType) {
+    std::vector<std::vector<fp32>> outputs;
+    for (const LayerData& image : images) {
+        resetConvLayerCounter();
+        resetDenseLayerCounter();
+        outputs.push_back(classProbabilities(model, model.inference(image, infType)));
+    }
+    return outputs;
+}
+
+std::size_t topClass(const std::vector<fp32>& probs) {
+    return static_cast<std::size_t>(std::max_element(probs.begin(), probs.end()) - probs.begin());
+}
+
+// Mean KL(reference || outputs) and % of images with the reference top-1 class
+void drift(const std::vector<std::vector<fp32>>& reference, const std::vector<std::vector<fp32>>& outputs,
+           double& meanKL, double& top1Agreement) {
+    double kl = 0.0;
+    std::size_t matches = 0;
+    for (std::size_t j = 0; j < outputs.size(); j++) {
+        kl += klDivergence(reference[j], outputs[j]);
+        matches += topClass(outputs[j]) == topClass(reference[j]);
+    }
+    meanKL = kl / outputs.size();
+    top1Agreement = 100.0 * matches / outputs.size();
+}
+
+}  // namespace
+
+std::string PrecisionReport::summary() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(4);
+    oss << "Mixed precision: " << packedBytes / 1024 << " KiB of quantized weights (" << int8Bytes / 1024
+        << " KiB all int8), calibrated on " << images << " images; all int8 vs fp32 KL " << std::setprecision(6)
+        << int8MeanKL << ", top-1 " << std::setprecision(0) << int8Top1Agreement << std::setprecision(4) << "%";
+    for (const PrecisionChoice& choice : choices) {
+        oss << "\n  L" << choice.layer << " " << choice.weights << " weights: int" << choice.bits << " (weight error int8 "
+            << choice.error8 << ", int4 " << choice.error4 << "; ";
+        if (choice.tried) {
+            oss << "at int4 output KL " << std::setprecision(6) << choice.meanKL << ", top-1 " << std::setprecision(0)
+                << choice.top1Agreement << std::setprecision(4) << "%)";
+        } else {
+            oss << "too small to try)";
+        }
+    }
+    return oss.str();
+}
+
+PrecisionReport selectWeightBits(Model& model, const PrecisionOptions& options) {
+    std::vector<LayerData> images;
+    for (std::size_t i = 0; i < options.images; i++) {
+        images.emplace_back(model[0].getInputParams(),
+                            options.imageDir / (options.imagePrefix + std::to_string(i) + ".bin"));
+        images.back().loadData();
+    }
+    if (images.empty()) {
+        throw std::runtime_error("selectWeightBits needs at least one calibration image");
+    }
+
+    // Per-layer calibration stats follow the call order, as in evaluateBatch
+    const bool convCalibration = isLayerSpecificCalibrationEnabled();
+    const bool denseCalibration = isDenseLayerSpecificCalibrationEnabled();
+    setCalibrationMode(true);
+    setDenseCalibrationMode(true);
+
+    PrecisionReport report;
+    report.images = images.size();
+    for (std::size_t i = 0; i < model.getNumLayers(); i++) {
+        Layer& layer = model[i];
+        std::size_t weights = 0;
+        if (const ConvolutionalLayer* conv = dynamic_cast<const ConvolutionalLayer*>(&layer)) {
+            weights = conv->getWeightParams().flat_count();
+        } else if (const DenseLayer* dense = dynamic_cast<const DenseLayer*>(&layer)) {
+            weights = dense->getWeightParams().flat_count();
+        } else {
+            continue;
+        }
+        layer.setWeightBits(8);
+        report.choices.push_back(PrecisionChoice{i, 8, layer.weightQuantizationError(8),
+                                                 layer.weightQuantizationError(4), weights, false, 0.0, 100.0});
+    }
+    const std::vector<std::vector<fp32>> fp32Outputs = classOutputs(model, images, Layer::InfType::NAIVE);
+    drift(fp32Outputs, classOutputs(model, images, Layer::InfType::QUANTIZED), report.int8MeanKL,
+          report.int8Top1Agreement);
+
+    std::vector<std::size_t> order;
+    for (std::size_t c = 0; c < report.choices.size(); c++) {
+        if (report.choices[c].weights >= options.minWeights) order.push_back(c);
+    }
+    std::sort(order.begin(), order.end(),
+              [&](std::size_t a, std::size_t b) { return report.choices[a].error4 < report.choices[b].error4; });
+
+    for (std::size_t c : order) {
+        PrecisionChoice& choice = report.choices[c];
+        Layer& layer = model[choice.layer];
+        layer.setWeightBits(4);
+        drift(fp32Outputs, classOutputs(model, images, Layer::InfType::QUANTIZED), choice.meanKL,
+              choice.top1Agreement);
+        choice.tried = true;
+        if (choice.meanKL <= report.int8MeanKL + options.maxMeanKL &&
+            choice.top1Agreement >= report.int8Top1Agreement - options.maxTop1Drop) {
+            choice.bits = 4;
+        } else {
+            layer.setWeightBits(8);
+        }
+    }
+
+    for (const PrecisionChoice& choice : report.choices) {
+        report.int8Bytes += choice.weights;
+        report.packedBytes += choice.bits == 4 ? int4Bytes(choice.weights) : choice.weights;
+    }
+    setCalibrationMode(convCalibration);
+    setDenseCalibrationMode(denseCalibration);
+    return report;
+}
+
+}  // namespace ML
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Model.h"
+#include "Utils.h"
+
+namespace ML {
+
+// Per-layer weight bit width for the quantized paths. Each large conv/dense layer is tried at
+// packed int4 (Layer::setWeightBits) and stays int4 only while the QUANTIZED model output on
+// a few calibration images stays within a budget of the fp32 (NAIVE) output: the mean KL
+// divergence of the class probabilities may grow by little over that of the all-int8 model,
+// and no image may lose the fp32 top-1 class the all-int8 model keeps. Layers are tried in
+// order of their int4 weight error (relative RMS, see Int4.h), so the ones that quantize best
+// get the budget first; the rest stay int8.
+struct PrecisionOptions {
+    Path imageDir = "data";
+    std::string imagePrefix = "image_";  // Calibration images are <imageDir>/<prefix>0.bin, 1, ...
+    std::size_t images = 3;
+    double maxMeanKL = 0.01;             // Max growth of the mean KL(fp32 || quantized) over all-int8
+    double maxTop1Drop = 0.0;            // Max drop (points) of the % of images keeping the fp32 top-1
+    std::size_t minWeights = 16 * 1024;  // Smaller layers stay int8 (little to save)
+};
+
+struct PrecisionChoice {
+    std::size_t layer;
+    unsigned bits;
+    double error8;  // Relative RMS weight error at int8
+    double error4;  // ... and at int4
+    std::size_t weights;
+    bool tried;            // Run at int4 (false below minWeights)
+    double meanKL;         // Output against fp32 with this layer (and the int4 ones before it) at int4
+    double top1Agreement;  // ... % of images with the fp32 top-1 class
+};
+
+struct PrecisionReport {
+    std::vector<PrecisionChoice> choices;  // One per conv/dense layer, in model order
+    std::size_t images = 0;                // Calibration images
+    double int8MeanKL = 0.0;               // All-int8 output against fp32
+    double int8Top1Agreement = 0.0;
+    std::size_t int8Bytes = 0;             // Quantized weight bytes if every layer stayed int8
+    std::size_t packedBytes = 0;           // ... with the chosen bit widths
+
+    // One line per layer for logInfo
+    std::string summary() const;
+};
+
+// Choose and set the weight bits of every conv/dense layer (layer buffers must be allocated).
+// Runs one NAIVE and (tried layers + 1) QUANTIZED inferences per calibration image.
+PrecisionReport selectWeightBits(Model& model, const PrecisionOptions& options = PrecisionOptions());
+
+}  // namespace ML
@@ -16,6 +16,9 @@ namespace ML {
 // infType can be used to determine the inference function to call
 const LayerData& Model::inference(const LayerData& inData, const Layer::InfType infType) const {
     assert(layers.size() > 0 && "There must be at least 1 layer to perform inference");
+    if (graph) {
+        return graph->run(inData, infType, profiler.get());
+    }
     inferenceLayer(inData, 0, infType);
 
     for (std::size_t i = 1; i < layers.size(); i++) {
@@ -25,6 +28,16 @@ const LayerData& Model::inference(const LayerData& inData, const Layer::InfType
     return layers.back()->getOutputData();
 }
 
+// Lower the layer list to the graph IR and run the fusion passes over it
+void Model::optimize(const std::vector<Graph::NamedPass>& passes) {
+    std::vector<Layer*> nodes;
+    for (const auto& layer : layers) {
+        nodes.push_back(layer.get());
+    }
+    graph.reset(new Graph(nodes));
+    graph->optimize(passes);
+}
+
 // Run inference on a single layer of the model using the inData and outputting the outData
 // infType can be used to determine the inference function to call
 const LayerData& Model::inferenceLayer(const LayerData& inData, const int layerNum, const Layer::InfType infType) const {
@@ -33,24 +46,12 @@ const LayerData& Model::inferenceLayer(const LayerData& inData, const int layerN
     assert(layer.getInputParams().isCompatible(inData.getParams()) && "Input data is not compatible with layer");
     assert(layer.isOutputBufferAlloced() && "Output buffer must be allocated prior to inference");
     
-    switch (infType) {
-    case Layer::InfType::NAIVE:
-        layer.computeNaive(inData);
-        break;
-    case Layer::InfType::THREADED:
-        layer.computeThreaded(inData);
-        break;
-    case Layer::InfType::TILED:
-        layer.computeTiled(inData);
-        break;
-    case Layer::InfType::SIMD:
-        layer.computeSIMD(inData);
-        break;
-    case Layer::InfType::QUANTIZED:
-        layer.computeQuantized(inData);
-        break;
-    default:
-        assert(false && "Inference Type not implemented");
+    if (profiler) {
+        Profiler::Scope scope(profiler.get(), "L" + std::to_string(layerNum) + " " + layerKindName(&layer),
+                              std::vector<const Layer*>{&layer}, layer.resolveInfType(infType), inData.getParams().byte_size());
+        layer.compute(inData, infType);
+    } else {
+        layer.compute(inData, infType);
     }
 
     return layer.getOutputData();
@@ -1,7 +1,10 @@
 #pragma once
+#include <algorithm>
 #include <vector>
 #include <memory>
 
+#include "Graph.h"
+#include "Profiler.h"
 #include "layers/Convolutional.h"
 #include "layers/Dense.h"
 #include "layers/Layer.h"
@@ -15,13 +18,25 @@ class Model {
     inline Model() : layers() {}  //, checkFinal(true), checkEachLayer(false) {}
 
     // Functions
+    // Runs the optimized graph if optimize() was called, else layer by layer
     const LayerData& inference(const LayerData& inData, const Layer::InfType infType = Layer::InfType::NAIVE) const;
     const LayerData& inferenceLayer(const LayerData& inData, const int layerNum, const Layer::InfType infType = Layer::InfType::NAIVE) const;
 
     // Generate calibration statistics by running naive inference
     void generateCalibration(const LayerData& inData, const std::string& outPath) const;
 
-    // Internal memory management
+    // Build the graph IR and run the fusion passes; inference() then executes fused nodes.
+    // Adding or removing layers drops the graph again.
+    void optimize(const std::vector<Graph::NamedPass>& passes = Graph::defaultPasses());
+    inline void clearOptimizations() { graph.reset(); }
+    inline const Graph* getGraph() const { return graph.get(); }
+
+    // Record every layer (or fused node) of inference() and inferenceLayer() in a Profiler
+    inline void enableProfiling(bool enable = true) {
+        if (!enable) profiler.reset();
+        else if (!profiler) profiler.reset(new Profiler());
+    }
+    inline Profiler* getProfiler() const { return profiler.get(); }
 
     // Internal memory management
     // Allocate the internal output buffers for each layer in the model
@@ -34,13 +49,19 @@ class Model {
     inline const std::size_t getNumLayers() const { return layers.size(); }
 
     // Add a layer to the model
-    template<typename T, typename... Args> void addLayer(Args&&... args) { layers.emplace_back(new T(std::forward<Args>(args)...)); }
+    template<typename T, typename... Args> void addLayer(Args&&... args) {
+        layers.emplace_back(new T(std::forward<Args>(args)...));
+        graph.reset();
+    }
 
     // Insert a layer into the model
     // void insertLayer(Layer* l, std::size_t idx) { layers.insert(layers.begin() + idx, l); }
 
     // Remove a layer from the model
-    inline void removeLayer(const std::size_t idx) { layers.erase(layers.begin() + idx); }
+    inline void removeLayer(const std::size_t idx) {
+        layers.erase(layers.begin() + idx);
+        graph.reset();
+    }
 
     // Get layer from the model
     inline Layer& getLayer(const std::size_t idx) { return *layers[idx]; }
@@ -62,20 +83,41 @@ class Model {
         return inferenceLayer(inData, layerNum, infType);
     }
 
+    // Shared scratch arena of the layers (sized by allocLayers)
+    inline const Workspace& getWorkspace() const { return *workspace; }
+
+    // (Re)attach the shared arena to every layer; a Pipeline gives each stage its own meanwhile
+    inline void shareWorkspace();
+
    private:
     std::vector<std::unique_ptr<Layer>> layers;
+    std::unique_ptr<Workspace> workspace{new Workspace()};  // Heap-held so layer pointers survive a move
+    std::unique_ptr<Graph> graph;                            // Set by optimize()
+    std::unique_ptr<Profiler> profiler;                      // Set by enableProfiling()
 };
 
 // Allocate the internal output buffers for each layer in the model
+// and one scratch arena large enough for any layer, shared by all of them
 void Model::allocLayers() {
+    std::size_t workspaceSize = 0;
     for (std::size_t i = 0; i < layers.size(); i++) {
         layers[i]->allocLayer();
+        workspaceSize = std::max(workspaceSize, layers[i]->getWorkspaceSize());
+    }
+    workspace->reserve(workspaceSize);
+    shareWorkspace();
+}
+
+void Model::shareWorkspace() {
+    for (std::size_t i = 0; i < layers.size(); i++) {
+        layers[i]->setWorkspace(workspace.get());
     }
 }
 
 // Free all layers in the model
 void Model::freeLayers() {
     // All classes use RAII, so just wipe out the vector of layers.
+    graph.reset();
     layers.clear();
 }
 }  // namespace ML
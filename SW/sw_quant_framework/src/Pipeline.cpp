@@ -0,0 +1,192 @@
+#include "Pipeline.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+
+#ifndef ZEDBOARD
+#include <mutex>
+#include <thread>
+#endif
+
+#include "BoundedQueue.h"
+#include "Utils.h"
+
+namespace ML {
+
+// Relative cost of a layer: MACs for conv/dense, one op per input element otherwise
+static double layerCost(const Layer& layer) {
+    const std::size_t macs = layer.getMacs();
+    return static_cast<double>(macs ? macs : layer.getInputParams().flat_count());
+}
+
+Pipeline::Pipeline(Model& model, std::size_t numStages, std::size_t queueDepth)
+    : model(model), queueDepth(std::max<std::size_t>(1, queueDepth)) {
+    const std::size_t numLayers = model.getNumLayers();
+    if (numLayers == 0) {
+        throw std::runtime_error("Pipeline needs a model with at least one layer");
+    }
+    if (numStages == 0) {
+#ifndef ZEDBOARD
+        numStages = std::max(1u, std::thread::hardware_concurrency());
+#else
+        numStages = 1;
+#endif
+    }
+    numStages = std::min(numStages, numLayers);
+
+    // Contiguous partition minimizing the cost of the slowest stage (prefix-sum DP)
+    std::vector<double> prefix(numLayers + 1, 0.0);
+    for (std::size_t i = 0; i < numLayers; i++) {
+        prefix[i + 1] = prefix[i] + layerCost(model[i]);
+    }
+    const double inf = std::numeric_limits<double>::infinity();
+    // best[k][j]: slowest stage when the first j layers form k stages; cut[k][j]: start of stage k
+    std::vector<std::vector<double>> best(numStages + 1, std::vector<double>(numLayers + 1, inf));
+    std::vector<std::vector<std::size_t>> cut(numStages + 1, std::vector<std::size_t>(numLayers + 1, 0));
+    best[0][0] = 0.0;
+    for (std::size_t k = 1; k <= numStages; k++) {
+        for (std::size_t j = k; j <= numLayers; j++) {
+            for (std::size_t i = k - 1; i < j; i++) {
+                const double slowest = std::max(best[k - 1][i], prefix[j] - prefix[i]);
+                if (slowest < best[k][j]) {
+                    best[k][j] = slowest;
+                    cut[k][j] = i;
+                }
+            }
+        }
+    }
+    stages.resize(numStages);
+    for (std::size_t k = numStages, j = numLayers; k > 0; k--) {
+        const std::size_t i = cut[k][j];
+        stages[k - 1] = Stage{i, j, prefix[j] - prefix[i]};
+        j = i;
+    }
+
+    // Stages run concurrently, so each needs its own scratch arena
+    for (const Stage& stage : stages) {
+        std::unique_ptr<Workspace> workspace(new Workspace());
+        for (std::size_t l = stage.first; l < stage.last; l++) {
+            workspace->reserve(model[l].getWorkspaceSize());
+            model[l].setWorkspace(workspace.get());
+        }
+        workspaces.push_back(std::move(workspace));
+    }
+
+    std::string layout;
+    for (const Stage& stage : stages) {
+        layout += " [" + std::to_string(stage.first) + ", " + std::to_string(stage.last) + ") " +
+                  std::to_string(static_cast<long long>(stage.cost / 1e6)) + "M";
+    }
+    logInfo("Pipeline: " + std::to_string(stages.size()) + " stages:" + layout);
+}
+
+Pipeline::~Pipeline() { model.shareWorkspace(); }
+
+#ifndef ZEDBOARD
+namespace {
+
+// Activations of one image between two stages
+struct PipelineItem {
+    std::size_t index;
+    std::unique_ptr<LayerData> data;
+};
+
+using PipelineQueue = BoundedQueue<PipelineItem>;
+
+}  // namespace
+#endif
+
+std::vector<LayerData> Pipeline::run(const std::vector<LayerData>& inputs, Layer::InfType infType) {
+    if (infType == Layer::InfType::QUANTIZED || infType == Layer::InfType::ACCELERATED) {
+        throw std::runtime_error("Pipeline supports the fp32 inference types only");
+    }
+
+    std::vector<std::unique_ptr<LayerData>> outputs(inputs.size());
+
+    // Run the layers of one stage on one image; returns the stage output
+    auto runStage = [&](const Stage& stage, const LayerData& in) -> const LayerData& {
+        const LayerData* current = &in;
+        for (std::size_t l = stage.first; l < stage.last; l++) {
+            model[l].compute(*current, infType);
+            current = &model[l].getOutputData();
+        }
+        return *current;
+    };
+
+#ifndef ZEDBOARD
+    if (stages.size() > 1) {
+        std::vector<std::unique_ptr<PipelineQueue>> queues;  // queues[s] feeds stage s + 1
+        for (std::size_t s = 0; s + 1 < stages.size(); s++) {
+            queues.emplace_back(new PipelineQueue(queueDepth));
+        }
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        auto stageLoop = [&](std::size_t s) {
+            const bool last = s + 1 == stages.size();
+            // Copy the stage output out of the layer buffer before the next image overwrites it
+            auto emit = [&](std::size_t index, const LayerData& out) {
+                std::unique_ptr<LayerData> copy(new LayerData(out));
+                if (last) {
+                    outputs[index] = std::move(copy);
+                    return true;
+                }
+                return queues[s]->push(PipelineItem{index, std::move(copy)});
+            };
+            try {
+                if (s == 0) {
+                    for (std::size_t i = 0; i < inputs.size(); i++) {
+                        if (!emit(i, runStage(stages[s], inputs[i]))) break;
+                    }
+                } else {
+                    PipelineItem item;
+                    while (queues[s - 1]->pop(item)) {
+                        if (!emit(item.index, runStage(stages[s], *item.data))) break;
+                    }
+                }
+                if (!last) queues[s]->close();
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) error = std::current_exception();
+                }
+                for (auto& queue : queues) {
+                    queue->abort();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (std::size_t s = 1; s < stages.size(); s++) {
+            threads.emplace_back(stageLoop, s);
+        }
+        stageLoop(0);  // The caller feeds the pipeline
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    } else
+#endif
+    {
+        for (std::size_t i = 0; i < inputs.size(); i++) {
+            const LayerData* current = &inputs[i];
+            for (const Stage& stage : stages) {
+                current = &runStage(stage, *current);
+            }
+            outputs[i].reset(new LayerData(*current));
+        }
+    }
+
+    std::vector<LayerData> results;
+    results.reserve(outputs.size());
+    for (auto& output : outputs) {
+        results.push_back(std::move(*output));
+    }
+    return results;
+}
+
+}  // namespace ML
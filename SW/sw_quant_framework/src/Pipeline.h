@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Model.h"
+
+namespace ML {
+
+// Layer-pipelined execution of a stream of independent images.
+// The model's layers are cut into contiguous stages of roughly equal cost; every stage
+// runs on its own thread and hands each image's activations to the next stage through a
+// bounded queue, so once the pipeline is full throughput is set by the slowest stage
+// instead of the sum of all layers. Each layer belongs to exactly one stage, so its output
+// buffer is only touched by that stage's thread; stages get their own scratch arenas.
+// Only the fp32 inference types are supported: the int8 paths select calibration stats by
+// a global call-order counter, which interleaved images would scramble.
+class Pipeline {
+   public:
+    // numStages = 0: one per hardware thread (at most one per layer)
+    // queueDepth: images buffered between two stages
+    explicit Pipeline(Model& model, std::size_t numStages = 0, std::size_t queueDepth = 2);
+    ~Pipeline();
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // Run every image through the model; result i is a copy of the model output for inputs[i]
+    std::vector<LayerData> run(const std::vector<LayerData>& inputs, Layer::InfType infType);
+
+    // Layer ranges [first, last) of the stages
+    struct Stage {
+        std::size_t first;
+        std::size_t last;
+        double cost;  // Estimated MACs (element ops for non-MAC layers)
+    };
+    const std::vector<Stage>& getStages() const { return stages; }
+
+   private:
+    Model& model;
+    std::size_t queueDepth;
+    std::vector<Stage> stages;
+    std::vector<std::unique_ptr<Workspace>> workspaces;  // One per stage
+};
+
+}  // namespace ML
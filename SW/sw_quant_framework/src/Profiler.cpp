@@ -0,0 +1,253 @@
+#include "Profiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Utils.h"
+
+#if defined(__linux__) && !defined(ZEDBOARD)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define ML_HAVE_PERF_EVENT 1
+#endif
+
+namespace ML {
+
+// --- PerfCounters ---
+#ifdef ML_HAVE_PERF_EVENT
+static int openCounter(uint32_t type, uint64_t config, int groupFd) {
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd < 0 ? 1 : 0;  // The leader starts the whole group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+
+PerfCounters::PerfCounters() {
+#ifdef ML_HAVE_PERF_EVENT
+    groupFd = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (groupFd < 0) {
+        return;
+    }
+    fds.push_back(groupFd);
+    const uint64_t events[] = {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES,
+                               PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (uint64_t event : events) {
+        fds.push_back(openCounter(PERF_TYPE_HARDWARE, event, groupFd));  // -1 if this one is unsupported
+    }
+    ioctl(groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef ML_HAVE_PERF_EVENT
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+PerfCounters::Values PerfCounters::read() const {
+    Values values;
+#ifdef ML_HAVE_PERF_EVENT
+    if (groupFd < 0) {
+        return values;
+    }
+    // Group read: count of members, then one value per member that opened
+    uint64_t buffer[1 + 5] = {};
+    if (::read(groupFd, buffer, sizeof(buffer)) <= 0) {
+        return values;
+    }
+    uint64_t* slots[] = {&values.cycles, &values.instructions, &values.cacheReferences, &values.cacheMisses,
+                         &values.branchMisses};
+    std::size_t next = 1;
+    for (std::size_t i = 0; i < fds.size() && next <= buffer[0]; i++) {
+        if (fds[i] >= 0) {
+            *slots[i] = buffer[next++];
+        }
+    }
+#endif
+    return values;
+}
+
+// --- Profiler ---
+Profiler::Profiler() : epoch(std::chrono::steady_clock::now()) {
+    if (!counters.available()) {
+        logInfo("Profiler: hardware counters unavailable, recording wall time only");
+    }
+}
+
+const char* Profiler::infTypeName(Layer::InfType infType) {
+    switch (infType) {
+    case Layer::InfType::NAIVE: return "NAIVE";
+    case Layer::InfType::THREADED: return "THREADED";
+    case Layer::InfType::TILED: return "TILED";
+    case Layer::InfType::SIMD: return "SIMD";
+    case Layer::InfType::QUANTIZED: return "QUANTIZED";
+    case Layer::InfType::ACCELERATED: return "ACCELERATED";
+    case Layer::InfType::AUTO: return "AUTO";
+    }
+    return "UNKNOWN";
+}
+
+Profiler::Scope::Scope(Profiler* profiler, const std::string& name, const std::vector<const Layer*>& layers,
+                       Layer::InfType infType, std::size_t inBytes)
+    : profiler(profiler), record() {
+    if (!profiler) {
+        return;
+    }
+    record.name = name;
+    record.infType = infType;
+    record.bytesRead = static_cast<double>(inBytes);
+    for (const Layer* layer : layers) {
+        record.macs += static_cast<double>(layer->getMacs());
+        record.bytesRead += static_cast<double>(layer->getWeightBytes());
+    }
+    // Intermediate outputs of a fused step stay in cache; only the last one is counted
+    record.bytesWritten = static_cast<double>(layers.back()->getOutputParams().byte_size());
+    record.counters = profiler->counters.read();
+    begin = std::chrono::steady_clock::now();
+}
+
+Profiler::Scope::~Scope() {
+    if (!profiler) {
+        return;
+    }
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    const PerfCounters::Values after = profiler->counters.read();
+    record.counters.cycles = after.cycles - record.counters.cycles;
+    record.counters.instructions = after.instructions - record.counters.instructions;
+    record.counters.cacheReferences = after.cacheReferences - record.counters.cacheReferences;
+    record.counters.cacheMisses = after.cacheMisses - record.counters.cacheMisses;
+    record.counters.branchMisses = after.branchMisses - record.counters.branchMisses;
+    record.startUs = std::chrono::duration<double, std::micro>(begin - profiler->epoch).count();
+    record.durationUs = std::chrono::duration<double, std::micro>(end - begin).count();
+    profiler->records.push_back(record);
+}
+
+std::vector<Profiler::Summary> Profiler::summarize() const {
+    std::vector<Summary> summaries;
+    std::vector<PerfCounters::Values> totals;
+    for (const Record& record : records) {
+        std::size_t i = 0;
+        while (i < summaries.size() && !(summaries[i].name == record.name && summaries[i].infType == record.infType)) {
+            i++;
+        }
+        if (i == summaries.size()) {
+            summaries.push_back(Summary{record.name, record.infType, 0, 0.0, record.macs,
+                                        record.bytesRead + record.bytesWritten, 0.0, 0.0, 0.0, 0.0});
+            totals.push_back(PerfCounters::Values());
+        }
+        summaries[i].calls++;
+        summaries[i].totalMs += record.durationUs / 1000.0;
+        totals[i].cycles += record.counters.cycles;
+        totals[i].instructions += record.counters.instructions;
+        totals[i].cacheReferences += record.counters.cacheReferences;
+        totals[i].cacheMisses += record.counters.cacheMisses;
+    }
+    for (std::size_t i = 0; i < summaries.size(); i++) {
+        Summary& s = summaries[i];
+        const double seconds = s.totalMs / 1000.0;
+        if (seconds > 0.0) {
+            s.gops = 2.0 * s.macs * s.calls / seconds / 1e9;
+            s.gbps = s.bytes * s.calls / seconds / 1e9;
+        }
+        if (totals[i].cycles) s.ipc = static_cast<double>(totals[i].instructions) / totals[i].cycles;
+        if (totals[i].cacheReferences) {
+            s.cacheMissRate = static_cast<double>(totals[i].cacheMisses) / totals[i].cacheReferences;
+        }
+    }
+    return summaries;
+}
+
+void Profiler::logSummary() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "Profile (" << records.size() << " records)\n";
+    oss << std::left << std::setw(24) << "layer" << std::setw(12) << "type" << std::right << std::setw(7) << "calls"
+        << std::setw(11) << "avg ms" << std::setw(10) << "GOPS" << std::setw(10) << "GB/s";
+    if (hasCounters()) oss << std::setw(8) << "IPC" << std::setw(10) << "miss %";
+    for (const Summary& s : summarize()) {
+        oss << "\n" << std::left << std::setw(24) << s.name << std::setw(12) << infTypeName(s.infType) << std::right
+            << std::setw(7) << s.calls << std::setw(11) << s.totalMs / s.calls << std::setw(10) << s.gops
+            << std::setw(10) << s.gbps;
+        if (hasCounters()) oss << std::setw(8) << s.ipc << std::setw(10) << 100.0 * s.cacheMissRate;
+    }
+    logInfo(oss.str());
+}
+
+bool Profiler::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        logError("Could not write profile to " + path);
+        return false;
+    }
+    out << "{\n  \"counters\": " << (hasCounters() ? "true" : "false") << ",\n  \"summary\": [\n";
+    const std::vector<Summary> summaries = summarize();
+    for (std::size_t i = 0; i < summaries.size(); i++) {
+        const Summary& s = summaries[i];
+        out << "    {\"name\": \"" << s.name << "\", \"type\": \"" << infTypeName(s.infType) << "\", \"calls\": "
+            << s.calls << ", \"total_ms\": " << s.totalMs << ", \"macs\": " << s.macs << ", \"bytes\": " << s.bytes
+            << ", \"gops\": " << s.gops << ", \"gbps\": " << s.gbps << ", \"ipc\": " << s.ipc
+            << ", \"cache_miss_rate\": " << s.cacheMissRate << "}" << (i + 1 < summaries.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n  \"records\": [\n";
+    for (std::size_t i = 0; i < records.size(); i++) {
+        const Record& r = records[i];
+        out << "    {\"name\": \"" << r.name << "\", \"type\": \"" << infTypeName(r.infType)
+            << "\", \"start_us\": " << r.startUs << ", \"duration_us\": " << r.durationUs << ", \"macs\": " << r.macs
+            << ", \"bytes_read\": " << r.bytesRead << ", \"bytes_written\": " << r.bytesWritten
+            << ", \"cycles\": " << r.counters.cycles << ", \"instructions\": " << r.counters.instructions
+            << ", \"cache_references\": " << r.counters.cacheReferences << ", \"cache_misses\": " << r.counters.cacheMisses
+            << ", \"branch_misses\": " << r.counters.branchMisses << "}" << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+bool Profiler::writeCsv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        logError("Could not write profile to " + path);
+        return false;
+    }
+    out << "name,type,calls,total_ms,avg_ms,macs,bytes,gops,gbps,ipc,cache_miss_rate\n";
+    for (const Summary& s : summarize()) {
+        out << s.name << "," << infTypeName(s.infType) << "," << s.calls << "," << s.totalMs << ","
+            << s.totalMs / s.calls << "," << s.macs << "," << s.bytes << "," << s.gops << "," << s.gbps << ","
+            << s.ipc << "," << s.cacheMissRate << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        logError("Could not write profile to " + path);
+        return false;
+    }
+    // Complete ("X") events; one track per inference type
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\": [\n";
+    for (std::size_t i = 0; i < records.size(); i++) {
+        const Record& r = records[i];
+        out << "  {\"name\": \"" << r.name << "\", \"cat\": \"layer\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+            << static_cast<int>(r.infType) << ", \"ts\": " << r.startUs << ", \"dur\": " << r.durationUs
+            << ", \"args\": {\"type\": \"" << infTypeName(r.infType) << "\", \"macs\": " << r.macs
+            << ", \"bytes_read\": " << r.bytesRead << ", \"bytes_written\": " << r.bytesWritten
+            << ", \"cycles\": " << r.counters.cycles << ", \"instructions\": " << r.counters.instructions << "}}"
+            << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    out << "], \"displayTimeUnit\": \"ms\"}\n";
+    return static_cast<bool>(out);
+}
+
+}  // namespace ML
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "layers/Layer.h"
+
+namespace ML {
+
+// Hardware counters of the calling thread (Linux perf_event, user space only).
+// Unavailable (all zero) on other platforms, on the ZedBoard, or when the kernel refuses
+// (perf_event_paranoid, containers); profiling then records wall time only.
+class PerfCounters {
+   public:
+    struct Values {
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+        uint64_t cacheReferences = 0;
+        uint64_t cacheMisses = 0;
+        uint64_t branchMisses = 0;
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return groupFd >= 0; }
+
+    // Counts since the process opened the counters (diff two reads for a region)
+    Values read() const;
+
+   private:
+    int groupFd = -1;
+    std::vector<int> fds;  // Leader first, in Values order
+};
+
+// Per-layer (or per fused node) profile of Model inference.
+// Model::enableProfiling() attaches one; every layer run then records wall time, MACs and
+// bytes moved (from Layer::getMacs / getWeightBytes and the tensor sizes) and, where
+// available, hardware counters. Records accumulate until clear().
+class Profiler {
+   public:
+    struct Record {
+        std::string name;       // "L3 conv", "L1-2 conv+pool", ...
+        Layer::InfType infType;
+        double startUs;         // Since the profiler was created
+        double durationUs;
+        double macs;
+        double bytesRead;       // Input + weights
+        double bytesWritten;    // Output
+        PerfCounters::Values counters;
+    };
+
+    // Records grouped by name and inference type
+    struct Summary {
+        std::string name;
+        Layer::InfType infType;
+        std::size_t calls;
+        double totalMs;
+        double macs;            // Per call
+        double bytes;           // Per call, read + written
+        double gops;            // 2 ops per MAC
+        double gbps;
+        double ipc;             // 0 without counters
+        double cacheMissRate;   // Misses per reference, 0 without counters
+    };
+
+    Profiler();
+
+    // Time one step that runs `layers` (in order) on an input of inBytes bytes
+    class Scope {
+       public:
+        Scope(Profiler* profiler, const std::string& name, const std::vector<const Layer*>& layers,
+              Layer::InfType infType, std::size_t inBytes);
+        ~Scope();
+
+       private:
+        Profiler* profiler;
+        Record record;
+        std::chrono::steady_clock::time_point begin;
+    };
+
+    const std::vector<Record>& getRecords() const { return records; }
+    std::vector<Summary> summarize() const;
+    bool hasCounters() const { return counters.available(); }
+    void clear() { records.clear(); }
+
+    // Per-layer table (totals per inference type) through logInfo
+    void logSummary() const;
+
+    // Exports; each returns false if the file could not be written
+    bool writeJson(const std::string& path) const;         // Summary and raw records
+    bool writeCsv(const std::string& path) const;          // One row per summary entry
+    bool writeChromeTrace(const std::string& path) const;  // chrome://tracing / Perfetto
+
+    static const char* infTypeName(Layer::InfType infType);
+
+   private:
+    std::chrono::steady_clock::time_point epoch;
+    PerfCounters counters;
+    std::vector<Record> records;
+};
+
+}  // namespace ML
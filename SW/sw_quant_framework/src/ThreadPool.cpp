@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace ML {
+
+ThreadPool::ThreadPool(std::size_t numThreads) {
+#ifndef ZEDBOARD
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 1; i < numThreads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+#else
+    (void)numThreads;
+#endif
+}
+
+ThreadPool::~ThreadPool() {
+#ifndef ZEDBOARD
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+#endif
+}
+
+static std::unique_ptr<ThreadPool>& sharedPool() {
+    static std::unique_ptr<ThreadPool> pool(new ThreadPool());
+    return pool;
+}
+
+ThreadPool& ThreadPool::shared() {
+    return *sharedPool();
+}
+
+void ThreadPool::setSharedThreads(std::size_t numThreads) {
+    std::unique_ptr<ThreadPool>& pool = sharedPool();
+    pool.reset();  // Join the old workers first
+    pool.reset(new ThreadPool(numThreads));
+}
+
+std::size_t ThreadPool::size() const {
+#ifndef ZEDBOARD
+    return workers.size() + 1;
+#else
+    return 1;
+#endif
+}
+
+#ifndef ZEDBOARD
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        taskReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+        if (stopping && tasks.empty()) {
+            return;
+        }
+        runOneTask(lock);
+    }
+}
+
+// Pop and run one queued task with the lock released. Returns false if the queue was empty.
+bool ThreadPool::runOneTask(std::unique_lock<std::mutex>& lock) {
+    if (tasks.empty()) {
+        return false;
+    }
+    std::function<void()> task = std::move(tasks.front());
+    tasks.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+    return true;
+}
+#endif
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t minChunk, const RangeFn& fn) {
+    if (count == 0) {
+        return;
+    }
+    minChunk = std::max<std::size_t>(1, minChunk);
+    const std::size_t numRanges = std::min(size(), (count + minChunk - 1) / minChunk);
+
+#ifndef ZEDBOARD
+    if (numRanges > 1) {
+        std::size_t pending = numRanges - 1;
+        std::exception_ptr error;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::size_t r = 1; r < numRanges; r++) {
+                const std::size_t begin = count * r / numRanges;
+                const std::size_t end = count * (r + 1) / numRanges;
+                tasks.emplace_back([this, &fn, &pending, &error, begin, end]() {
+                    std::exception_ptr taskError;
+                    try {
+                        fn(begin, end);
+                    } catch (...) {
+                        taskError = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (taskError && !error) {
+                        error = taskError;
+                    }
+                    pending--;
+                    taskDone.notify_all();
+                });
+            }
+        }
+        taskReady.notify_all();
+        taskDone.notify_all();  // Threads waiting in a parallelFor help with new tasks too
+
+        std::exception_ptr callerError;
+        try {
+            fn(0, count / numRanges);
+        } catch (...) {
+            callerError = std::current_exception();
+        }
+
+        // Help with queued work while waiting so nested calls cannot starve the pool
+        std::unique_lock<std::mutex> lock(mutex);
+        while (pending > 0) {
+            if (!runOneTask(lock)) {
+                taskDone.wait(lock);
+            }
+        }
+        if (callerError) {
+            std::rethrow_exception(callerError);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
+#endif
+
+    (void)numRanges;
+    fn(0, count);
+}
+
+}  // namespace ML
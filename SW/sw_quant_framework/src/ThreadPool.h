@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#ifndef ZEDBOARD
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace ML {
+
+// Fixed-size worker pool shared by all layer kernels.
+// On the ZedBoard (bare metal, no threads) every job runs on the caller.
+class ThreadPool {
+   public:
+    // Range of work items [begin, end) handed to one worker
+    using RangeFn = std::function<void(std::size_t begin, std::size_t end)>;
+
+    // numThreads includes the calling thread (0 = all hardware threads)
+    explicit ThreadPool(std::size_t numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool used by the layers
+    static ThreadPool& shared();
+
+    // Replace the shared pool with one of numThreads threads (0 = all hardware threads).
+    // Only while no layer is running (thread sweeps in the benchmark).
+    static void setSharedThreads(std::size_t numThreads);
+
+    // Number of threads that run work (workers + caller)
+    std::size_t size() const;
+
+    // Split [0, count) into at most size() contiguous ranges of at least minChunk items
+    // and run fn on each; the caller runs the first range. Blocks until all ranges are
+    // done and rethrows the first exception. Safe to call from inside a job.
+    void parallelFor(std::size_t count, std::size_t minChunk, const RangeFn& fn);
+
+    // Work a range needs before it is worth its own task, in elementary operations (one
+    // multiply-add, one compare): far more than waking a worker and joining it costs
+    static const std::size_t MIN_WORK_PER_TASK = 32 * 1024;
+
+    // minChunk for items of workPerItem operations each (at least 1)
+    static std::size_t minChunk(std::size_t workPerItem) {
+        return workPerItem >= MIN_WORK_PER_TASK ? 1 : MIN_WORK_PER_TASK / (workPerItem ? workPerItem : 1);
+    }
+
+   private:
+#ifndef ZEDBOARD
+    void workerLoop();
+    bool runOneTask(std::unique_lock<std::mutex>& lock);
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable taskDone;
+    bool stopping = false;
+#endif
+};
+
+}  // namespace ML
@@ -0,0 +1,144 @@
+#include "ToyModel.h"
+
+#include "Types.h"
+#include "Utils.h"
+#include "layers/Convolutional.h"
+#include "layers/Dense.h"
+#include "layers/Flatten.h"
+#include "layers/MaxPooling.h"
+#include "layers/Softmax.h"
+
+namespace ML {
+
+// Build our ML toy model
+Model buildToyModel(const Path modelPath) {
+    Model model;
+    logInfo("--- Building Toy Model ---");
+
+    // --- Conv 1: L1 ---
+    // Input shape: 64x64x3
+    // Output shape: 60x60x32
+    model.addLayer<ConvolutionalLayer>(
+        LayerParams{sizeof(fp32), {64, 64, 3}},                                    // Input Data
+        LayerParams{sizeof(fp32), {60, 60, 32}},                                   // Output Data
+        LayerParams{sizeof(fp32), {5, 5, 3, 32}, modelPath / "conv1_weights.bin"}, // Weights
+        LayerParams{sizeof(fp32), {32}, modelPath / "conv1_biases.bin"}            // Bias
+    );
+
+    // --- Conv 2: L2 ---
+    // Input shape: 60x60x32
+    // Output shape: 56x56x32
+    model.addLayer<ConvolutionalLayer>(
+        LayerParams{sizeof(fp32), {60, 60, 32}},                                   // Input Data
+        LayerParams{sizeof(fp32), {56, 56, 32}},                                   // Output Data
+        LayerParams{sizeof(fp32), {5, 5, 32, 32}, modelPath / "conv2_weights.bin"}, // Weights
+        LayerParams{sizeof(fp32), {32}, modelPath / "conv2_biases.bin"}            // Bias
+    );
+
+    // --- MPL 1: L3 ---
+    // Input shape: 56x56x32
+    // Output shape: 28x28x32
+    model.addLayer<MaxPoolingLayer>(
+        LayerParams{sizeof(fp32), {56, 56, 32}},                                   // Input Data
+        LayerParams{sizeof(fp32), {28, 28, 32}},                                   // Output Data
+        LayerParams{sizeof(fp32), {2, 2}}                                          // Pool size
+    );
+
+    // --- Conv 3: L4 ---
+    // Input shape: 28x28x32
+    // Output shape: 26x26x64
+    model.addLayer<ConvolutionalLayer>(
+        LayerParams{sizeof(fp32), {28, 28, 32}},                                   // Input Data
+        LayerParams{sizeof(fp32), {26, 26, 64}},                                   // Output Data
+        LayerParams{sizeof(fp32), {3, 3, 32, 64}, modelPath / "conv3_weights.bin"}, // Weights
+        LayerParams{sizeof(fp32), {64}, modelPath / "conv3_biases.bin"}            // Bias
+    );
+
+    // --- Conv 4: L5 ---
+    // Input shape: 26x26x64
+    // Output shape: 24x24x64
+    model.addLayer<ConvolutionalLayer>(
+        LayerParams{sizeof(fp32), {26, 26, 64}},                                   // Input Data
+        LayerParams{sizeof(fp32), {24, 24, 64}},                                   // Output Data
+        LayerParams{sizeof(fp32), {3, 3, 64, 64}, modelPath / "conv4_weights.bin"}, // Weights
+        LayerParams{sizeof(fp32), {64}, modelPath / "conv4_biases.bin"}            // Bias
+    );
+
+    // --- MPL 2: L6 ---
+    // Input shape: 24x24x64
+    // Output shape: 12x12x64
+    model.addLayer<MaxPoolingLayer>(
+        LayerParams{sizeof(fp32), {24, 24, 64}},                                   // Input Data
+        LayerParams{sizeof(fp32), {12, 12, 64}},                                   // Output Data
+        LayerParams{sizeof(fp32), {2, 2}}                                          // Pool size
+    );
+
+    // --- Conv 5: L7 ---
+    // Input shape: 12x12x64
+    // Output shape: 10x10x64
+    model.addLayer<ConvolutionalLayer>(
+        LayerParams{sizeof(fp32), {12, 12, 64}},                                   // Input Data
+        LayerParams{sizeof(fp32), {10, 10, 64}},                                   // Output Data
+        LayerParams{sizeof(fp32), {3, 3, 64, 64}, modelPath / "conv5_weights.bin"}, // Weights
+        LayerParams{sizeof(fp32), {64}, modelPath / "conv5_biases.bin"}            // Bias
+    );
+
+    // --- Conv 6: L8 ---
+    // Input shape: 10x10x64
+    // Output shape: 8x8x128
+    model.addLayer<ConvolutionalLayer>(
+        LayerParams{sizeof(fp32), {10, 10, 64}},                                   // Input Data
+        LayerParams{sizeof(fp32), {8, 8, 128}},                                    // Output Data
+        LayerParams{sizeof(fp32), {3, 3, 64, 128}, modelPath / "conv6_weights.bin"}, // Weights
+        LayerParams{sizeof(fp32), {128}, modelPath / "conv6_biases.bin"}           // Bias
+    );
+
+    // --- MPL 3: L9 ---
+    // Input shape: 8x8x128
+    // Output shape: 4x4x128
+    model.addLayer<MaxPoolingLayer>(
+        LayerParams{sizeof(fp32), {8, 8, 128}},                                    // Input Data
+        LayerParams{sizeof(fp32), {4, 4, 128}},                                    // Output Data
+        LayerParams{sizeof(fp32), {2, 2}}                                          // Pool size
+    );
+
+    // --- Flatten: L10 ---
+    // Input shape: 4x4x128 = 2048
+    // Output shape: 2048 (flattened)
+    model.addLayer<FlattenLayer>(
+        LayerParams{sizeof(fp32), {4, 4, 128}},                                    // Input Data (4D)
+        LayerParams{sizeof(fp32), {2048}}                                          // Output Data (1D flattened)
+    );
+
+    // --- Dense 1: L11 ---
+    // Input shape: 2048
+    // Output shape: 256
+    model.addLayer<DenseLayer>(
+        LayerParams{sizeof(fp32), {2048}},                                         // Input Data (flattened)
+        LayerParams{sizeof(fp32), {256}},                                          // Output Data
+        LayerParams{sizeof(fp32), {2048, 256}, modelPath / "dense1_weights.bin"}, // Weights
+        LayerParams{sizeof(fp32), {256}, modelPath / "dense1_biases.bin"}         // Bias
+    );
+
+    // --- Dense 2: L12 ---
+    // Input shape: 256
+    // Output shape: 200
+    model.addLayer<DenseLayer>(
+        LayerParams{sizeof(fp32), {256}},                                          // Input Data
+        LayerParams{sizeof(fp32), {200}},                                          // Output Data
+        LayerParams{sizeof(fp32), {256, 200}, modelPath / "dense2_weights.bin"},  // Weights
+        LayerParams{sizeof(fp32), {200}, modelPath / "dense2_biases.bin"}         // Bias
+    );
+
+    // --- Softmax 1: L13 ---
+    // Input shape: 200
+    // Output shape: 200
+    model.addLayer<SoftmaxLayer>(
+        LayerParams{sizeof(fp32), {200}},                                          // Input Data
+        LayerParams{sizeof(fp32), {200}}                                           // Output Data
+    );
+
+    return model;
+}
+
+}  // namespace ML
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Model.h"
+#include "Utils.h"
+
+namespace ML {
+
+// The 13-layer toy CNN (64x64x3 image -> 200 class scores), weights read from modelPath.
+// Shared by the test driver (ML.cpp) and the benchmark (bench/Benchmark.cpp).
+Model buildToyModel(const Path modelPath);
+
+}  // namespace ML
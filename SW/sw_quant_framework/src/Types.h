@@ -4,6 +4,13 @@
 #include <type_traits>
 #include <vector>
 
+// Pointer aliasing hint for kernel loops (input/weight/output buffers never overlap)
+#if defined(_MSC_VER)
+#define ML_RESTRICT __restrict
+#else
+#define ML_RESTRICT __restrict__
+#endif
+
 namespace ML {
 
 // --- Data Types ---
@@ -1,6 +1,135 @@
 #include "Utils.h"
 
+#include <memory>
+
+#ifndef ZEDBOARD
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
 namespace ML {
+
+// --- Log level ---
+#ifndef ZEDBOARD
+static std::atomic<int> runtimeLogLevel(static_cast<int>(LogLevel::Info));
+#else
+static int runtimeLogLevel = static_cast<int>(LogLevel::Info);
+#endif
+
+LogLevel logLevel() { return static_cast<LogLevel>(static_cast<int>(runtimeLogLevel)); }
+
+void setLogLevel(LogLevel level) { runtimeLogLevel = static_cast<int>(level); }
+
+// --- Log sink ---
+#ifndef ZEDBOARD
+// Lines are appended to a pending buffer; the writer thread swaps it out and writes the
+// whole batch with one call, so logging threads never wait on the terminal.
+class AsyncLogSink {
+   public:
+    AsyncLogSink() : writer(&AsyncLogSink::writerLoop, this) {}
+
+    ~AsyncLogSink() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        writer.join();
+    }
+
+    void write(const std::string& line) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending += line;
+        pending += '\n';
+        wake.notify_all();
+    }
+
+    // Block until everything written so far reached std::cout
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [this]() { return pending.empty() && !writing; });
+    }
+
+   private:
+    void writerLoop() {
+        std::string batch;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if (pending.empty() && stopping) {
+                return;
+            }
+            batch.swap(pending);
+            writing = true;
+            lock.unlock();
+            std::cout.write(batch.data(), batch.size());
+            std::cout.flush();
+            batch.clear();
+            lock.lock();
+            writing = false;
+            drained.notify_all();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::string pending;
+    bool writing = false;
+    bool stopping = false;
+    std::thread writer;
+};
+
+static std::mutex asyncSinkMutex;
+static std::unique_ptr<AsyncLogSink> asyncSink;
+#endif
+
+void logWrite(const std::string& line, bool error) {
+#ifndef ZEDBOARD
+    {
+        std::lock_guard<std::mutex> lock(asyncSinkMutex);
+        if (asyncSink && !error) {
+            asyncSink->write(line);
+            return;
+        }
+        if (asyncSink) {
+            asyncSink->flush();  // Keep errors after everything logged before them
+        }
+    }
+#endif
+    if (error) {
+        std::cout.flush();
+        std::cerr << line << '\n';
+    } else {
+        std::cout << line << '\n';
+    }
+}
+
+void logFlush() {
+#ifndef ZEDBOARD
+    std::lock_guard<std::mutex> lock(asyncSinkMutex);
+    if (asyncSink) {
+        asyncSink->flush();
+    }
+#endif
+    std::cout.flush();
+}
+
+void setLogAsync(bool async) {
+#ifndef ZEDBOARD
+    std::lock_guard<std::mutex> lock(asyncSinkMutex);
+    if (async && !asyncSink) {
+        asyncSink.reset(new AsyncLogSink());
+    } else if (!async && asyncSink) {
+        asyncSink.reset();  // Writes out what is pending and joins the writer
+    }
+#else
+    (void)async;
+#endif
+}
+
 // #void exportQuantizedWeights(const std::string& filename, 
 //                            const std::vector<int8_t>& weights,
 //                            const std::vector<int32_t>& biases) {
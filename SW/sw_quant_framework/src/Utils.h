@@ -81,6 +81,49 @@ class LogMod {
     friend std::ostream& operator<<(std::ostream& os, const LogMod& mod) { return os << "\033[" << mod.code << "m"; }
 };
 
+// --- Log levels ---
+// Messages above the compile-time level ML_LOG_LEVEL (0 = off ... 4 = debug) are compiled
+// out; the runtime level (setLogLevel, default Info) filters the rest. The ML_LOG_* macros
+// only build their message when the level is enabled, so disabled logging on hot paths
+// costs a single compare (nothing at all below ML_LOG_LEVEL): no formatting, no allocation.
+enum class LogLevel { Off = 0, Error = 1, Warn = 2, Info = 3, Debug = 4 };
+
+#ifndef ML_LOG_LEVEL
+#define ML_LOG_LEVEL 4
+#endif
+
+LogLevel logLevel();
+void setLogLevel(LogLevel level);
+
+inline bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) <= ML_LOG_LEVEL && static_cast<int>(level) <= static_cast<int>(logLevel());
+}
+
+// --- Log sink ---
+// Lines go to std::cout without a per-line flush (errors flush it and go to std::cerr).
+// In async mode a background thread writes them in batches; call logFlush() before printing
+// to std::cout directly so the output stays in order. Async is ignored on the ZedBoard.
+void logWrite(const std::string& line, bool error = false);
+void logFlush();
+void setLogAsync(bool async);
+
+#define ML_LOG_AT(level, fn, msg)          \
+    do {                                   \
+        if (::ML::logEnabled(level)) {     \
+            fn(msg);                       \
+        }                                  \
+    } while (0)
+
+#define ML_LOG_DEBUG(msg) ML_LOG_AT(::ML::LogLevel::Debug, ::ML::logDebug, msg)
+#define ML_LOG_INFO(msg) ML_LOG_AT(::ML::LogLevel::Info, ::ML::logInfo, msg)
+#define ML_LOG_WARN(msg) ML_LOG_AT(::ML::LogLevel::Warn, ::ML::logWarn, msg)
+
+// Colored level tag, or the plain one
+inline std::string logTag(const char* name, CCode color) {
+    if (!Config::FANCY_LOGGING) return std::string("[") + name + "]: ";
+    return "[\033[" + std::to_string(color) + "m" + name + "\033[" + std::to_string(CCode::FG_DEFAULT) + "m]: ";
+}
+
 // TODO: Use fmt lib formatting for colors and other styles instead if available
 // Log a non-decorated message
 #ifndef STR_FORMAT_NONE
@@ -89,10 +132,7 @@ template <typename... Args> inline void log(const std::string_view& fmt_str, Arg
 #else
 template <typename... Args> inline void log(const std::string& msg, Args&&... args) {
 #endif
-    if (Config::FANCY_LOGGING)
-        std::cout << msg << std::endl;
-    else
-        std::cout << msg << std::endl;
+    if (logEnabled(LogLevel::Info)) logWrite(msg);
 }
 
 // Log a info Message
@@ -102,10 +142,7 @@ template <typename... Args> inline void logInfo(const std::string_view& fmt_str,
 #else
 template <typename... Args> inline void logInfo(const std::string& msg, Args&&... args) {
 #endif
-    if (Config::FANCY_LOGGING)
-        std::cout << "[" << LogMod(CCode::FG_CYAN) << "Info" << LogMod(CCode::FG_DEFAULT) << "]: " << msg << std::endl;
-    else
-        std::cout << "[Info]: " << msg << std::endl;
+    if (logEnabled(LogLevel::Info)) logWrite(logTag("Info", CCode::FG_CYAN) + msg);
 }
 
 // Log a debug Message
@@ -115,10 +152,7 @@ template <typename... Args> inline void logDebug(const std::string_view& fmt_str
 #else
 template <typename... Args> inline void logDebug(const std::string& msg, Args&&... args) {
 #endif
-    if (Config::FANCY_LOGGING)
-        std::cout << "[" << LogMod(CCode::FG_GREEN) << "Debug" << LogMod(CCode::FG_DEFAULT) << "]: " << msg << std::endl;
-    else
-        std::cout << "[Debug]: " << msg << std::endl;
+    if (logEnabled(LogLevel::Debug)) logWrite(logTag("Debug", CCode::FG_GREEN) + msg);
 }
 
 // Log a warning Message
@@ -128,10 +162,7 @@ template <typename... Args> inline void logWarn(const std::string_view& fmt_str,
 #else
 template <typename... Args> inline void logWarn(const std::string& msg, Args&&... args) {
 #endif
-    if (Config::FANCY_LOGGING)
-        std::cout << "[" << LogMod(CCode::FG_YELLOW) << "Warning" << LogMod(CCode::FG_DEFAULT) << "]: " << msg << std::endl;
-    else
-        std::cout << "[Warning]: " << msg << std::endl;
+    if (logEnabled(LogLevel::Warn)) logWrite(logTag("Warning", CCode::FG_YELLOW) + msg);
 }
 
 // Log an error Message
@@ -141,10 +172,7 @@ template <typename... Args> inline void logError(const std::string_view& fmt_str
 #else
 template <typename... Args> inline void logError(const std::string& msg, Args&&... args) {
 #endif
-    if (Config::FANCY_LOGGING)
-        std::cerr << "[" << LogMod(CCode::FG_RED) << "Error" << LogMod(CCode::FG_DEFAULT) << "]: " << msg << std::endl;
-    else
-        std::cerr << "[Error]: " << msg << std::endl;
+    if (logEnabled(LogLevel::Error)) logWrite(logTag("Error", CCode::FG_RED) + msg, true);
 }
 
 // --- Timing Functions ---
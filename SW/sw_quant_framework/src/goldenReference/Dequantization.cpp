@@ -2,6 +2,10 @@
 #include <algorithm>
 #include <cmath>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 /**
  * Constructor
  */
@@ -26,7 +30,7 @@ void Dequantization::setQuantParams(int32_t zero_point_in,
  * Example: 0x01000000 = 1.0 in Q8.24
  *          0x00800000 = 0.5 in Q8.24
  */
-int32_t Dequantization::fixedPointMultiply(int32_t value, int32_t scale) {
+int32_t Dequantization::fixedPointMultiply(int32_t value, int32_t scale) const {
     // Perform 64-bit multiplication to avoid overflow
     int64_t temp = (int64_t)value * scale;
     
@@ -40,7 +44,7 @@ int32_t Dequantization::fixedPointMultiply(int32_t value, int32_t scale) {
 /**
  * Saturate to int8 range [-128, 127]
  */
-int8_t Dequantization::saturateToInt8(int32_t value) {
+int8_t Dequantization::saturateToInt8(int32_t value) const {
     if (value > 127) return 127;
     if (value < -128) return -128;
     return (int8_t)value;
@@ -99,23 +103,68 @@ int8_t Dequantization::dequantizeScalar(int32_t accumulator, OutputStats* stats)
  */
 std::vector<int8_t> Dequantization::dequantizeVector(const std::vector<int32_t>& accumulators,
                                                     std::vector<OutputStats>* stats) {
-    std::vector<int8_t> results;
-    results.reserve(accumulators.size());
+    std::vector<int8_t> results(accumulators.size());
     
-    if (stats != nullptr) {
-        stats->clear();
-        stats->reserve(accumulators.size());
+    if (stats == nullptr) {
+        dequantizeBuffer(accumulators.data(), results.data(), accumulators.size());
+        return results;
     }
     
-    for (int32_t accum : accumulators) {
-        OutputStats local_stats;
-        int8_t result = dequantizeScalar(accum, &local_stats);
-        results.push_back(result);
-        
-        if (stats != nullptr) {
-            stats->push_back(local_stats);
-        }
+    stats->clear();
+    stats->reserve(accumulators.size());
+    for (size_t i = 0; i < accumulators.size(); i++) {
+        stats->push_back(dequantizePipelined(accumulators[i]));
+        results[i] = stats->back().final;
     }
     
     return results;
 }
+
+/**
+ * Bulk requantization
+ *
+ * Processes the buffer front to back. In place, element i is read from bytes
+ * [4i, 4i+4) and written to byte i, so a store never reaches an unread value.
+ */
+void Dequantization::dequantizeBuffer(const int32_t* accumulators, int8_t* outputs, size_t count) const {
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i zp_in = _mm256_set1_epi32(config_.zero_point_in);
+    const __m256i zp_out = _mm256_set1_epi32(config_.zero_point_out);
+    const __m256i scale = _mm256_set1_epi32(config_.scale_factor);
+    const __m256i half = _mm256_set1_epi64x(0x00800000);
+    // max() against INT32_MIN leaves the value unchanged when ReLU is off
+    const __m256i relu_floor = _mm256_set1_epi32(config_.enable_relu ? 0 : INT32_MIN);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulators + i));
+        acc = _mm256_sub_epi32(acc, zp_in);
+
+        // Signed 32x32->64 multiply of even and odd lanes, round, >> 24.
+        // The low 32 bits of a logical and an arithmetic shift by 24 are the same.
+        __m256i even = _mm256_mul_epi32(acc, scale);
+        __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(acc, 32), scale);
+        even = _mm256_srli_epi64(_mm256_add_epi64(even, half), 24);
+        odd = _mm256_srli_epi64(_mm256_add_epi64(odd, half), 24);
+        __m256i product = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+
+        product = _mm256_max_epi32(product, relu_floor);
+        product = _mm256_add_epi32(product, zp_out);
+
+        // Saturate 32 -> 16 -> 8 (two saturating packs clamp to [-128, 127])
+        __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(product),
+                                        _mm256_extracti128_si256(product, 1));
+        __m128i bytes = _mm_packs_epi16(words, words);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(outputs + i), bytes);
+    }
+#endif
+
+    for (; i < count; i++) {
+        int32_t value = fixedPointMultiply(accumulators[i] - config_.zero_point_in, config_.scale_factor);
+        if (config_.enable_relu && value < 0) {
+            value = 0;
+        }
+        outputs[i] = saturateToInt8(value + config_.zero_point_out);
+    }
+}
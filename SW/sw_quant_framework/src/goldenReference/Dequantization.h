@@ -2,6 +2,7 @@
 #define DEQUANTIZATION_H
 
 #include <cstdint>
+#include <cstddef>
 #include <vector>
 
 /**
@@ -69,6 +70,8 @@ public:
     /**
      * Dequantize vector of accumulators
      * 
+     * Without stats this runs the bulk requantizer (dequantizeBuffer).
+     * 
      * @param accumulators Vector of int32 accumulator values
      * @param stats [optional] Vector to store per-value statistics
      * @return Vector of int8 outputs
@@ -76,6 +79,20 @@ public:
     std::vector<int8_t> dequantizeVector(const std::vector<int32_t>& accumulators,
                                         std::vector<OutputStats>* stats = nullptr);
 
+    /**
+     * Bulk requantization of an accumulator buffer
+     * 
+     * Same stages as dequantizeScalar, bit-exact with dequantizePipelined.
+     * Uses AVX2 (8 accumulators per step) when compiled with it (SIMD=true),
+     * otherwise a scalar loop. outputs may alias accumulators for in-place
+     * use: element i is written to byte i of the buffer after it is read.
+     * 
+     * @param accumulators int32 accumulator values
+     * @param outputs int8 results (count bytes)
+     * @param count Number of values
+     */
+    void dequantizeBuffer(const int32_t* accumulators, int8_t* outputs, size_t count) const;
+
     /**
      * Dequantize with pipeline stages separated (for cycle-by-cycle comparison)
      * 
@@ -113,12 +130,12 @@ private:
      * @param scale Scale factor in Q8.24
      * @return Scaled value (rounded)
      */
-    int32_t fixedPointMultiply(int32_t value, int32_t scale);
+    int32_t fixedPointMultiply(int32_t value, int32_t scale) const;
 
     /**
      * Saturate value to int8 range
      */
-    int8_t saturateToInt8(int32_t value);
+    int8_t saturateToInt8(int32_t value) const;
 };
 
 #endif // DEQUANTIZATION_H
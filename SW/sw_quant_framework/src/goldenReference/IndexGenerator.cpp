@@ -45,7 +45,7 @@ IndexGenerator::IndexGenerator(const ConvConfig& config,
  * 
  * input_addr = input_base + (in_y * input_width + in_x) * input_channels + ic
  */
-uint32_t IndexGenerator::calcInputAddr(uint16_t in_y, uint16_t in_x, uint8_t ic) {
+uint32_t IndexGenerator::calcInputAddr(uint16_t in_y, uint16_t in_x, uint16_t ic) const {
     uint32_t offset = ((uint32_t)in_y * conv_config_.input_width + in_x) 
                       * conv_config_.input_channels + ic;
     return input_base_addr_ + offset;
@@ -59,7 +59,7 @@ uint32_t IndexGenerator::calcInputAddr(uint16_t in_y, uint16_t in_x, uint8_t ic)
  *                              fy * filter_w * input_c +
  *                              fx * input_c + ic)
  */
-uint32_t IndexGenerator::calcWeightAddr(uint8_t oc, uint8_t fy, uint8_t fx, uint8_t ic) {
+uint32_t IndexGenerator::calcWeightAddr(uint16_t oc, uint8_t fy, uint8_t fx, uint16_t ic) const {
     uint32_t offset = ((uint32_t)oc * conv_config_.filter_height * conv_config_.filter_width * conv_config_.input_channels
                       + (uint32_t)fy * conv_config_.filter_width * conv_config_.input_channels
                       + (uint32_t)fx * conv_config_.input_channels
@@ -73,7 +73,7 @@ uint32_t IndexGenerator::calcWeightAddr(uint8_t oc, uint8_t fy, uint8_t fx, uint
  */
 bool IndexGenerator::calcInputPosition(uint16_t out_y, uint16_t out_x,
                                        uint8_t fy, uint8_t fx,
-                                       uint16_t& in_y, uint16_t& in_x) {
+                                       uint16_t& in_y, uint16_t& in_x) const {
     // Calculate top-left corner of input window for this output position
     // in_y_start = out_y * stride - padding
     // Then add filter offset: in_y = in_y_start + fy
@@ -95,7 +95,7 @@ bool IndexGenerator::calcInputPosition(uint16_t out_y, uint16_t out_x,
 /**
  * Generate all addresses for complete layer
  * 
- * Loop nesting (row-stationary dataflow):
+ * Drains an AddressStream into one vector. Loop nesting (row-stationary dataflow):
  *   for oc_batch = 0 to (num_filters / 4 - 1):  # Process 4 output channels at a time
  *     for tile_id = 0 to total_tiles-1:
  *       for out_y_in_tile = 0 to tile_size-1:
@@ -112,93 +112,188 @@ bool IndexGenerator::calcInputPosition(uint16_t out_y, uint16_t out_x,
  *                       emit (input_addr, weight_addr, tlast=(ic==input_channels-1), oc=oc%4)
  */
 std::vector<IndexGenerator::Address> IndexGenerator::generateAllAddresses() {
-    std::vector<Address> addresses;
+    std::vector<Address> addresses((size_t)totalAddresses());
 
-    uint32_t num_output_channels = conv_config_.num_filters;
-    uint16_t output_height = conv_config_.output_height;
-    uint16_t output_width = conv_config_.output_width;
-    uint8_t filter_height = conv_config_.filter_height;
-    uint8_t filter_width = conv_config_.filter_width;
-    uint8_t input_channels = conv_config_.input_channels;
+    AddressStream addr_stream(*this);
+    addresses.resize(addr_stream.fill(addresses.data(), addresses.size()));
 
-    // Process output channels in groups of 4 (4 parallel MACs)
-    for (uint8_t oc_batch = 0; oc_batch < (num_output_channels + 3) / 4; oc_batch++) {
-        
-        // Process each tile
-        for (uint16_t tile_id = 0; tile_id < tile_config_.total_tiles; tile_id++) {
-            uint16_t tile_row = tile_id / tile_config_.tiles_per_row;
-            uint16_t tile_col = tile_id % tile_config_.tiles_per_row;
-            
-            // Process each pixel within tile
-            for (uint16_t out_y_in_tile = 0; out_y_in_tile < tile_config_.tile_size; out_y_in_tile++) {
-                for (uint16_t out_x_in_tile = 0; out_x_in_tile < tile_config_.tile_size; out_x_in_tile++) {
-                    
-                    uint16_t actual_out_y = tile_row * tile_config_.tile_size + out_y_in_tile;
-                    uint16_t actual_out_x = tile_col * tile_config_.tile_size + out_x_in_tile;
-                    
-                    // Skip if outside output bounds
-                    if (actual_out_y >= output_height || actual_out_x >= output_width) {
-                        continue;
-                    }
+    return addresses;
+}
+
+/**
+ * Generate first N addresses (for quick validation)
+ */
+std::vector<IndexGenerator::Address> IndexGenerator::generateFirstN(uint32_t n) {
+    std::vector<Address> addresses((size_t)std::min<uint64_t>(n, totalAddresses()));
+
+    AddressStream addr_stream(*this);
+    addresses.resize(addr_stream.fill(addresses.data(), addresses.size()));
+
+    return addresses;
+}
+
+/**
+ * Total MAC operations in the layer
+ */
+uint64_t IndexGenerator::totalAddresses() const {
+    return (uint64_t)conv_config_.output_height * conv_config_.output_width
+           * conv_config_.num_filters * conv_config_.macs_per_pixel;
+}
+
+/**
+ * AddressStream - positioned at the first address of the layer
+ */
+IndexGenerator::AddressStream::AddressStream(const IndexGenerator& gen) : gen_(&gen) {
+    num_batches_ = (gen.conv_config_.num_filters + 3) / 4;
+    reset();
+}
+
+void IndexGenerator::AddressStream::reset() {
+    oc_batch_ = 0;
+    tile_id_ = 0;
+    tile_y_ = 0;
+    tile_x_ = 0;
+    out_y_ = 0;
+    out_x_ = 0;
+    oc_offset_ = 0;
+    fy_ = 0;
+    fx_ = 0;
+    ic_ = 0;
+    position_ = 0;
+    done_ = (num_batches_ == 0);
+}
+
+/**
+ * Position at the first pixel of (oc_batch, tile_id)
+ */
+void IndexGenerator::AddressStream::seek(uint16_t oc_batch, uint16_t tile_id) {
+    const TileConfig& tiles = gen_->tile_config_;
+    const ConvConfig& conv = gen_->conv_config_;
+
+    reset();
+    if (oc_batch >= num_batches_ || tile_id >= tiles.total_tiles) {
+        position_ = gen_->totalAddresses();
+        done_ = true;
+        return;
+    }
+
+    // Addresses before this point: all earlier oc batches, then earlier tiles of this batch
+    const uint64_t layer_pixels = (uint64_t)conv.output_height * conv.output_width;
+    for (uint16_t b = 0; b < oc_batch; b++) {
+        uint32_t lanes = std::min<uint32_t>(4, conv.num_filters - (uint32_t)b * 4);
+        position_ += layer_pixels * lanes * conv.macs_per_pixel;
+    }
+    uint64_t tile_pixels = 0;
+    for (uint16_t t = 0; t < tile_id; t++) {
+        uint32_t row0 = (t / tiles.tiles_per_row) * tiles.tile_size;
+        uint32_t col0 = (t % tiles.tiles_per_row) * tiles.tile_size;
+        tile_pixels += (uint64_t)std::min<uint32_t>(tiles.tile_size, conv.output_height - row0)
+                       * std::min<uint32_t>(tiles.tile_size, conv.output_width - col0);
+    }
+    uint32_t lanes = std::min<uint32_t>(4, conv.num_filters - (uint32_t)oc_batch * 4);
+    position_ += tile_pixels * lanes * conv.macs_per_pixel;
+
+    // A tile's origin is always inside the output
+    oc_batch_ = oc_batch;
+    tile_id_ = tile_id;
+    out_y_ = (tile_id / tiles.tiles_per_row) * tiles.tile_size;
+    out_x_ = (tile_id % tiles.tiles_per_row) * tiles.tile_size;
+}
+
+/**
+ * Move to the next pixel inside the output, crossing tile and oc batch boundaries
+ */
+void IndexGenerator::AddressStream::advancePixel() {
+    const TileConfig& tiles = gen_->tile_config_;
+    const ConvConfig& conv = gen_->conv_config_;
 
-                    // Process 4 output channels in parallel (4 MACs)
-                    for (uint8_t oc_offset = 0; oc_offset < 4; oc_offset++) {
-                        uint8_t oc = oc_batch * 4 + oc_offset;
-                        
-                        // Skip if this output channel doesn't exist
-                        if (oc >= num_output_channels) {
-                            continue;
-                        }
-
-                        // Generate MAC operations for this output pixel and channel
-                        // Iterate filter positions and input channels
-                        for (uint8_t fy = 0; fy < filter_height; fy++) {
-                            for (uint8_t fx = 0; fx < filter_width; fx++) {
-                                for (uint8_t ic = 0; ic < input_channels; ic++) {
-                                    
-                                    // Calculate input position (handles padding)
-                                    uint16_t in_y = 0, in_x = 0;
-                                    calcInputPosition(actual_out_y, actual_out_x, fy, fx, in_y, in_x);
-
-                                    // Always generate address (for padding regions, input reads zero from BRAM initialization)
-                                    uint32_t input_addr = calcInputAddr(in_y, in_x, ic);
-                                    uint32_t weight_addr = calcWeightAddr(oc, fy, fx, ic);
-
-                                    Address addr;
-                                    addr.input_addr = input_addr;
-                                    addr.weight_addr = weight_addr;
-                                    // TLAST asserted only on LAST MAC of this output pixel
-                                    // = last input channel (ic == input_channels-1) AND
-                                    //   last filter position (fy == filter_height-1 and fx == filter_width-1)
-                                    addr.tlast = (ic == input_channels - 1 && 
-                                                  fy == filter_height - 1 && 
-                                                  fx == filter_width - 1);
-                                    addr.oc = oc_offset;  // Which of 4 parallel MACs (0-3)
-
-                                    addresses.push_back(addr);
-                                }
-                            }
-                        }
+    do {
+        if (++tile_x_ == tiles.tile_size) {
+            tile_x_ = 0;
+            if (++tile_y_ == tiles.tile_size) {
+                tile_y_ = 0;
+                if (++tile_id_ == tiles.total_tiles) {
+                    tile_id_ = 0;
+                    if (++oc_batch_ == num_batches_) {
+                        done_ = true;
+                        return;
                     }
                 }
             }
         }
+        out_y_ = (tile_id_ / tiles.tiles_per_row) * tiles.tile_size + tile_y_;
+        out_x_ = (tile_id_ % tiles.tiles_per_row) * tiles.tile_size + tile_x_;
+    } while (out_y_ >= conv.output_height || out_x_ >= conv.output_width);
+}
+
+/**
+ * Step past the current address (innermost loop first: ic -> fx -> fy -> oc_offset -> pixel)
+ */
+void IndexGenerator::AddressStream::advance() {
+    const ConvConfig& conv = gen_->conv_config_;
+
+    position_++;
+    if (++ic_ < conv.input_channels) return;
+    ic_ = 0;
+    if (++fx_ < conv.filter_width) return;
+    fx_ = 0;
+    if (++fy_ < conv.filter_height) return;
+    fy_ = 0;
+    if (++oc_offset_ < 4 && (uint32_t)oc_batch_ * 4 + oc_offset_ < conv.num_filters) return;
+    oc_offset_ = 0;
+    advancePixel();
+}
+
+/**
+ * Produce next address
+ */
+bool IndexGenerator::AddressStream::next(Address& addr) {
+    if (done_) {
+        return false;
     }
 
-    return addresses;
+    const ConvConfig& conv = gen_->conv_config_;
+
+    // Calculate input position (handles padding)
+    uint16_t in_y = 0, in_x = 0;
+    gen_->calcInputPosition(out_y_, out_x_, fy_, fx_, in_y, in_x);
+
+    // Always generate address (for padding regions, input reads zero from BRAM initialization)
+    addr.input_addr = gen_->calcInputAddr(in_y, in_x, ic_);
+    addr.weight_addr = gen_->calcWeightAddr(oc_batch_ * 4 + oc_offset_, fy_, fx_, ic_);
+    // TLAST asserted only on LAST MAC of this output pixel
+    // = last input channel (ic == input_channels-1) AND
+    //   last filter position (fy == filter_height-1 and fx == filter_width-1)
+    addr.tlast = (ic_ == conv.input_channels - 1 &&
+                  fy_ == conv.filter_height - 1 &&
+                  fx_ == conv.filter_width - 1);
+    addr.oc = oc_offset_;  // Which of 4 parallel MACs (0-3)
+
+    advance();
+    return true;
 }
 
 /**
- * Generate first N addresses (for quick validation)
+ * Produce a span of addresses
  */
-std::vector<IndexGenerator::Address> IndexGenerator::generateFirstN(uint32_t n) {
-    std::vector<Address> all_addresses = generateAllAddresses();
-    
-    if (n >= all_addresses.size()) {
-        return all_addresses;
+size_t IndexGenerator::AddressStream::fill(Address* out, size_t max_count) {
+    size_t count = 0;
+    while (count < max_count && next(out[count])) {
+        count++;
     }
-    
-    return std::vector<Address>(all_addresses.begin(), all_addresses.begin() + n);
+    return count;
+}
+
+/**
+ * Skip addresses
+ */
+uint64_t IndexGenerator::AddressStream::skip(uint64_t count) {
+    uint64_t skipped = 0;
+    while (skipped < count && !done_) {
+        advance();
+        skipped++;
+    }
+    return skipped;
 }
 
 /**
@@ -210,8 +305,7 @@ bool IndexGenerator::verifyAddresses(const std::vector<Address>& addresses) {
         return false;
     }
 
-    uint32_t expected_total_macs = (uint32_t)conv_config_.output_height * conv_config_.output_width 
-                                   * conv_config_.num_filters * conv_config_.macs_per_pixel;
+    uint64_t expected_total_macs = totalAddresses();
 
     // Check total count
     if (addresses.size() != expected_total_macs) {
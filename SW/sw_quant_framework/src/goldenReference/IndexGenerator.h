@@ -2,6 +2,7 @@
 #define INDEX_GENERATOR_H
 
 #include <cstdint>
+#include <cstddef>
 #include <vector>
 
 /**
@@ -57,6 +58,87 @@ public:
         uint16_t total_tiles;     ///< Total tiles = tiles_per_row * tiles_per_col
     };
 
+    /**
+     * AddressStream - lazy, resumable address generator
+     *
+     * Yields the same sequence as generateAllAddresses() one address (next())
+     * or one span (fill()) at a time, keeping only the loop counters. Lets the
+     * reference model and sequencer emulation walk full-size layers in
+     * constant memory.
+     *
+     * The stream references its IndexGenerator, which must outlive it.
+     */
+    class AddressStream {
+    public:
+        explicit AddressStream(const IndexGenerator& gen);
+
+        /**
+         * Produce the next address
+         *
+         * @param addr [out] Next address in execution order
+         * @return False once the layer is exhausted (addr untouched)
+         */
+        bool next(Address& addr);
+
+        /**
+         * Produce up to max_count addresses into a caller-provided span
+         *
+         * @param out Destination buffer (at least max_count entries)
+         * @param max_count Span size
+         * @return Number of addresses written (less than max_count only at the end)
+         */
+        size_t fill(Address* out, size_t max_count);
+
+        /**
+         * Skip ahead without producing addresses
+         *
+         * @param count Number of addresses to skip
+         * @return Number of addresses actually skipped
+         */
+        uint64_t skip(uint64_t count);
+
+        /**
+         * Restart from the first address of the layer
+         */
+        void reset();
+
+        /**
+         * Jump to the first address of a tile within an oc batch
+         *
+         * oc batches and tiles are independent units of work, so a stream
+         * positioned here can be handed to a separate worker.
+         *
+         * @param oc_batch Output channel batch
+         * @param tile_id Tile within the batch
+         */
+        void seek(uint16_t oc_batch, uint16_t tile_id);
+
+        bool done() const { return done_; }
+        uint64_t position() const { return position_; }   ///< Addresses produced so far
+
+        // Position of the next address (valid while !done())
+        uint16_t ocBatch() const { return oc_batch_; }
+        uint16_t tileId() const { return tile_id_; }
+        uint16_t outY() const { return out_y_; }
+        uint16_t outX() const { return out_x_; }
+
+    private:
+        const IndexGenerator* gen_;
+        uint16_t oc_batch_;
+        uint16_t num_batches_;
+        uint16_t tile_id_;
+        uint16_t tile_y_, tile_x_;     ///< Pixel offset within tile
+        uint16_t out_y_, out_x_;       ///< Actual output pixel
+        uint8_t oc_offset_;
+        uint8_t fy_, fx_;
+        uint16_t ic_;
+        uint64_t position_;
+        bool done_;
+
+        void advance();                ///< Step past the current address
+        void advancePixel();           ///< Move to the next in-bounds pixel (or next oc batch)
+    };
+
     /**
      * Constructor
      * 
@@ -87,6 +169,17 @@ public:
      */
     std::vector<Address> generateAllAddresses();
 
+    /**
+     * Create a streaming generator positioned at the first address
+     */
+    AddressStream stream() const { return AddressStream(*this); }
+
+    /**
+     * Total number of addresses in the layer
+     * = output_height X output_width X num_filters X macs_per_pixel
+     */
+    uint64_t totalAddresses() const;
+
     /**
      * Generate addresses for first N operations
      * 
@@ -133,7 +226,7 @@ private:
      * @param ic Input channel
      * @return BRAM address for this element
      */
-    uint32_t calcInputAddr(uint16_t in_y, uint16_t in_x, uint8_t ic);
+    uint32_t calcInputAddr(uint16_t in_y, uint16_t in_x, uint16_t ic) const;
 
     /**
      * Calculate weight address for given filter and input channel
@@ -148,7 +241,7 @@ private:
      * @param ic Input channel
      * @return BRAM address for this weight
      */
-    uint32_t calcWeightAddr(uint8_t oc, uint8_t fy, uint8_t fx, uint8_t ic);
+    uint32_t calcWeightAddr(uint16_t oc, uint8_t fy, uint8_t fx, uint16_t ic) const;
 
     /**
      * Calculate input row/column from output position and filter offset
@@ -169,7 +262,7 @@ private:
      */
     bool calcInputPosition(uint16_t out_y, uint16_t out_x, 
                           uint8_t fy, uint8_t fx,
-                          uint16_t& in_y, uint16_t& in_x);
+                          uint16_t& in_y, uint16_t& in_x) const;
 };
 
 #endif // INDEX_GENERATOR_H
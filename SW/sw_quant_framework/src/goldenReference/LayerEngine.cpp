@@ -0,0 +1,296 @@
+#include "LayerEngine.h"
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include <exception>
+
+#ifndef ZEDBOARD
+#include <thread>
+#endif
+
+/**
+ * Constructor - derive geometry and size the BRAMs
+ */
+LayerEngine::LayerEngine(const Config& config)
+    : config_(config),
+      index_gen_(config.conv, 0, 0, config.tile_size) {
+
+    // Pick up derived output geometry from the index generator
+    config_.conv = index_gen_.getConvConfig();
+
+    input_bram_.assign(inputSize(), 0);
+    weight_bram_.assign(weightSize(), 0);
+    biases_.assign(config_.conv.num_filters, 0);
+    output_bram_.assign((outputSize() + 3) / 4, 0);
+}
+
+size_t LayerEngine::inputSize() const {
+    return (size_t)config_.conv.input_height * config_.conv.input_width * config_.conv.input_channels;
+}
+
+size_t LayerEngine::weightSize() const {
+    return (size_t)config_.conv.num_filters * config_.conv.macs_per_pixel;
+}
+
+size_t LayerEngine::outputSize() const {
+    return (size_t)config_.conv.output_height * config_.conv.output_width * config_.conv.num_filters;
+}
+
+/**
+ * DMA input activations
+ */
+void LayerEngine::loadInput(const int8_t* data, size_t count) {
+    if (count != input_bram_.size()) {
+        throw std::invalid_argument("Input size does not match layer configuration");
+    }
+    std::memcpy(input_bram_.data(), data, count);
+}
+
+/**
+ * DMA weights
+ */
+void LayerEngine::loadWeights(const int8_t* data, size_t count) {
+    if (count != weight_bram_.size()) {
+        throw std::invalid_argument("Weight size does not match layer configuration");
+    }
+    std::memcpy(weight_bram_.data(), data, count);
+}
+
+/**
+ * Load per-channel biases
+ */
+void LayerEngine::loadBiases(const int32_t* data, size_t count) {
+    if (count != biases_.size()) {
+        throw std::invalid_argument("Bias count does not match layer configuration");
+    }
+    biases_.assign(data, data + count);
+}
+
+/**
+ * Repack HWIO -> OHWI
+ */
+void LayerEngine::packWeightsHWIO(const int8_t* hwio, int8_t* ohwi,
+                                  uint32_t filter_h, uint32_t filter_w,
+                                  uint32_t in_channels, uint32_t out_channels) {
+    for (uint32_t m = 0; m < out_channels; m++) {
+        for (uint32_t r = 0; r < filter_h; r++) {
+            for (uint32_t s = 0; s < filter_w; s++) {
+                for (uint32_t c = 0; c < in_channels; c++) {
+                    size_t src = ((r * filter_w + s) * in_channels + c) * out_channels + m;
+                    size_t dst = ((m * filter_h + r) * filter_w + s) * in_channels + c;
+                    ohwi[dst] = hwio[src];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Run a contiguous range of (oc_batch, tile) jobs
+ *
+ * Consumes the IndexGenerator address stream one pixel span at a time. The 4 oc segments
+ * of a pixel are issued to the 4 MAC lanes in parallel (segment k goes to lane k); lanes
+ * without a channel get zero weights. Each pixel runs through the batched MAC path, which
+ * matches the cycle-by-cycle cluster in accumulators and cycle count. The biased accumulators
+ * of a job are requantized in one bulk pass and scattered to the int8 staging tensor; every
+ * job owns distinct output channels, so workers never share a byte.
+ */
+LayerEngine::RunStats LayerEngine::runJobs(uint32_t first_job, uint32_t last_job,
+                                           std::vector<int8_t>& staging) const {
+    const IndexGenerator::ConvConfig& conv = config_.conv;
+    const uint32_t macs_per_pixel = conv.macs_per_pixel;
+    const uint32_t total_tiles = index_gen_.getTileConfig().total_tiles;
+
+    RunStats stats = {};
+
+    MACStreamProvider::Config mac_config;
+    mac_config.num_macs = 4;
+    mac_config.zero_point_in = config_.zero_point_in;
+    mac_config.zero_point_weight = 0;
+    MACStreamProvider mac_cluster(mac_config);
+
+    Dequantization::Config dq_config;
+    dq_config.zero_point_in = 0;
+    dq_config.zero_point_out = config_.zero_point_out;
+    dq_config.scale_factor = config_.scale_factor;
+    dq_config.enable_relu = config_.enable_relu;
+    dq_config.enable_batch_norm = false;
+    Dequantization dequant(dq_config);
+
+    // Biased accumulators of one job ([pixel][lane]), requantized in place once the job ends
+    std::vector<int32_t> job_accum;
+    std::vector<uint32_t> job_pixels;
+
+    // One pixel of one oc batch: up to 4 segments of macs_per_pixel addresses
+    std::vector<IndexGenerator::Address> pixel(4 * macs_per_pixel);
+    IndexGenerator::AddressStream addr_stream = index_gen_.stream();
+    uint32_t current_batch = UINT32_MAX;
+
+    // Per-lane operand streams; lanes without a channel get zero weights
+    std::vector<int8_t> lane_inputs_buf(4 * macs_per_pixel);
+    std::vector<int8_t> lane_weights_buf(4 * macs_per_pixel);
+    const int8_t* lane_inputs_ptr[4];
+    const int8_t* lane_weights_ptr[4];
+    uint32_t lanes = 0;
+
+    for (uint32_t job = first_job; job < last_job; job++) {
+        const uint32_t oc_batch = job / total_tiles;
+        const uint32_t tile_id = job % total_tiles;
+        const uint32_t oc_base = oc_batch * 4;
+
+        if (oc_batch != current_batch) {
+            current_batch = oc_batch;
+            lanes = std::min<uint32_t>(4, conv.num_filters - oc_base);
+        }
+
+        job_accum.clear();
+        job_pixels.clear();
+        addr_stream.seek(oc_batch, tile_id);
+        while (!addr_stream.done() && addr_stream.ocBatch() == oc_batch && addr_stream.tileId() == tile_id) {
+            const uint32_t out_y = addr_stream.outY();
+            const uint32_t out_x = addr_stream.outX();
+
+            if (addr_stream.fill(pixel.data(), lanes * macs_per_pixel) != lanes * macs_per_pixel) {
+                throw std::runtime_error("Address stream ended inside a pixel");
+            }
+
+            // Gather each lane's operand stream from BRAM, then run the pixel batched
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                int8_t* lane_inputs = &lane_inputs_buf[lane * macs_per_pixel];
+                int8_t* lane_weights = &lane_weights_buf[lane * macs_per_pixel];
+                if (lane < lanes) {
+                    const IndexGenerator::Address* addr = &pixel[lane * macs_per_pixel];
+                    for (uint32_t k = 0; k < macs_per_pixel; k++) {
+                        lane_inputs[k] = input_bram_[addr[k].input_addr];
+                        lane_weights[k] = weight_bram_[addr[k].weight_addr];
+                    }
+                    if (!addr[macs_per_pixel - 1].tlast) {
+                        throw std::runtime_error("Address stream ended a pixel without TLAST");
+                    }
+                } else {
+                    std::fill(lane_inputs, lane_inputs + macs_per_pixel, 0);
+                    std::fill(lane_weights, lane_weights + macs_per_pixel, 0);
+                }
+                lane_inputs_ptr[lane] = lane_inputs;
+                lane_weights_ptr[lane] = lane_weights;
+            }
+            MACStreamProvider::Output result = mac_cluster.executePixel(lane_inputs_ptr, lane_weights_ptr,
+                                                                        macs_per_pixel);
+            stats.macs += (uint64_t)lanes * macs_per_pixel;
+            stats.pixels++;
+
+            // Bias is the dequantizer input zero-point folded into the accumulator:
+            // acc - (-bias) = acc + bias
+            for (uint32_t lane = 0; lane < lanes; lane++) {
+                job_accum.push_back(result.accum[lane] + biases_[oc_base + lane]);
+            }
+            job_pixels.push_back(out_y * conv.output_width + out_x);
+        }
+
+        int8_t* job_out = reinterpret_cast<int8_t*>(job_accum.data());
+        dequant.dequantizeBuffer(job_accum.data(), job_out, job_accum.size());
+        for (size_t p = 0; p < job_pixels.size(); p++) {
+            std::memcpy(&staging[(size_t)job_pixels[p] * conv.num_filters + oc_base], &job_out[p * lanes], lanes);
+        }
+    }
+
+    stats.cycles = mac_cluster.getCycleCount();
+    return stats;
+}
+
+/**
+ * Run the whole layer
+ *
+ * The (oc_batch, tile) jobs of the loop nest are split into contiguous ranges, one per
+ * worker. Once all workers finish, the staged int8 results are written to the output
+ * BRAM through OutputStorage in HWC order, so the BRAM image does not depend on the
+ * number of threads. Cycle counts are summed: the hardware still runs the jobs back to back.
+ */
+LayerEngine::RunStats LayerEngine::start() {
+    const IndexGenerator::ConvConfig& conv = config_.conv;
+    const uint32_t num_jobs = (uint32_t)((conv.num_filters + 3) / 4) * index_gen_.getTileConfig().total_tiles;
+
+    uint32_t num_threads = config_.num_threads;
+#ifndef ZEDBOARD
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+#else
+    num_threads = 1;
+#endif
+    num_threads = std::max(1u, std::min(num_threads, num_jobs));
+
+    std::vector<int8_t> staging(outputSize());
+    std::vector<RunStats> worker_stats(num_threads);
+
+#ifndef ZEDBOARD
+    if (num_threads > 1) {
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(num_threads);
+        for (uint32_t t = 0; t < num_threads; t++) {
+            uint32_t first = (uint32_t)((uint64_t)num_jobs * t / num_threads);
+            uint32_t last = (uint32_t)((uint64_t)num_jobs * (t + 1) / num_threads);
+            workers.emplace_back([this, t, first, last, &staging, &worker_stats, &errors]() {
+                try {
+                    worker_stats[t] = runJobs(first, last, staging);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    } else
+#endif
+    {
+        worker_stats[0] = runJobs(0, num_jobs, staging);
+    }
+
+    // Deterministic merge into the output BRAM (read-modify-write per byte)
+    OutputStorage::Config out_config;
+    out_config.output_height = conv.output_height;
+    out_config.output_width = conv.output_width;
+    out_config.output_channels = conv.num_filters;
+    out_config.enable_pooling = false;
+    out_config.output_base_addr = 0;
+    OutputStorage storage(out_config);
+
+    size_t idx = 0;
+    for (uint16_t y = 0; y < conv.output_height; y++) {
+        for (uint16_t x = 0; x < conv.output_width; x++) {
+            for (uint16_t c = 0; c < conv.num_filters; c++) {
+                storage.writeOutput(y, x, c, staging[idx++], output_bram_);
+            }
+        }
+    }
+
+    RunStats stats = {};
+    for (const auto& ws : worker_stats) {
+        stats.cycles += ws.cycles;
+        stats.macs += ws.macs;
+        stats.pixels += ws.pixels;
+    }
+    // Final pipeline drain (multiply -> accumulate -> register)
+    stats.cycles += StagedMAC::PIPELINE_LATENCY;
+    stats.threads = num_threads;
+
+    return stats;
+}
+
+/**
+ * Read back int8 outputs
+ */
+void LayerEngine::readOutput(int8_t* data, size_t count) const {
+    if (count != outputSize()) {
+        throw std::invalid_argument("Output size does not match layer configuration");
+    }
+    for (size_t i = 0; i < count; i++) {
+        data[i] = (int8_t)((output_bram_[i / 4] >> ((i % 4) * 8)) & 0xFF);
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef LAYER_ENGINE_H
+#define LAYER_ENGINE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "IndexGenerator.h"
+#include "StagedMAC.h"
+#include "Dequantization.h"
+#include "OutputStorage.h"
+
+/**
+ * LayerEngine - C++ Reference Implementation
+ *
+ * Whole-layer convolution engine built from the golden reference blocks.
+ * Models the accelerator as a layer engine rather than a MAC coprocessor:
+ *
+ * 1. DMA: input activations (int8, HWC) and weights (int8, OHWI) are loaded
+ *    into the simulated BRAMs, per-channel biases into the dequantizer
+ * 2. start(): one kick runs the full layer. The IndexGenerator address stream
+ *    drives the 4 StagedMAC lanes, each TLAST feeds the 4 Dequantization lanes
+ *    and OutputStorage packs the int8 results into the output BRAM
+ * 3. readOutput(): int8 readback of the output BRAM (HWC)
+ *
+ * The address stream is produced pixel by pixel so a layer never has to be
+ * materialized as a full address vector.
+ *
+ * This class serves as a golden reference for VHDL hardware validation.
+ */
+class LayerEngine {
+public:
+    /**
+     * Layer job description
+     */
+    struct Config {
+        IndexGenerator::ConvConfig conv;  ///< Layer geometry (derived fields filled in)
+        uint16_t tile_size;               ///< Output tile size (16 for 16x16 tiles)
+        int32_t zero_point_in;            ///< Input activation zero-point (removed in the MACs)
+        int32_t zero_point_out;           ///< Output zero-point
+        int32_t scale_factor;             ///< Requantization scale in Q8.24
+        bool enable_relu;                 ///< Apply ReLU before saturation
+        uint32_t num_threads;             ///< Simulation workers (0 = all cores, forced to 1 on ZEDBOARD)
+    };
+
+    /**
+     * Execution statistics of one start()
+     */
+    struct RunStats {
+        uint64_t cycles;          ///< MAC cluster cycles including pipeline drain
+        uint64_t macs;            ///< Useful MAC operations issued
+        uint32_t pixels;          ///< Output pixels completed (per oc batch)
+        uint32_t threads;         ///< Simulation workers used
+    };
+
+    /**
+     * Constructor
+     *
+     * @param config Layer job (geometry, quantization parameters)
+     */
+    explicit LayerEngine(const Config& config);
+
+    /**
+     * DMA input activations into the input BRAM
+     *
+     * @param data int8 activations in HWC order
+     * @param count Number of elements (input_height * input_width * input_channels)
+     */
+    void loadInput(const int8_t* data, size_t count);
+
+    /**
+     * DMA weights into the weight BRAM
+     *
+     * @param data int8 weights in OHWI order (BRAM layout)
+     * @param count Number of elements (num_filters * filter_h * filter_w * input_channels)
+     */
+    void loadWeights(const int8_t* data, size_t count);
+
+    /**
+     * Load per-output-channel int32 biases
+     *
+     * Biases are folded into the dequantizer zero-point, so they must be in
+     * accumulator scale (input_scale * weight_scale).
+     *
+     * @param data Biases, one per output channel
+     * @param count Number of biases (num_filters)
+     */
+    void loadBiases(const int32_t* data, size_t count);
+
+    /**
+     * Repack HWIO weights (framework layout) into the OHWI weight BRAM layout
+     *
+     * @param hwio Source weights [R][S][C][M]
+     * @param ohwi Destination weights [M][R][S][C]
+     */
+    static void packWeightsHWIO(const int8_t* hwio, int8_t* ohwi,
+                                uint32_t filter_h, uint32_t filter_w,
+                                uint32_t in_channels, uint32_t out_channels);
+
+    /**
+     * Run the whole layer
+     *
+     * Independent (oc_batch, tile) jobs are simulated on up to num_threads
+     * workers; the output BRAM and cycle count are identical for any
+     * thread count.
+     *
+     * @return Cycle and MAC counts of the run
+     */
+    RunStats start();
+
+    /**
+     * Read back the int8 output tensor
+     *
+     * @param data Destination in HWC order
+     * @param count Number of elements (output_height * output_width * num_filters)
+     */
+    void readOutput(int8_t* data, size_t count) const;
+
+    /**
+     * Get configuration (derived geometry filled in)
+     */
+    const Config& getConfig() const { return config_; }
+
+    /**
+     * Get raw output BRAM words
+     */
+    const std::vector<uint32_t>& getOutputBRAM() const { return output_bram_; }
+
+private:
+    Config config_;
+    IndexGenerator index_gen_;
+    std::vector<int8_t> input_bram_;
+    std::vector<int8_t> weight_bram_;
+    std::vector<int32_t> biases_;
+    std::vector<uint32_t> output_bram_;
+
+    /**
+     * Simulate jobs [first_job, last_job) (job = oc_batch * total_tiles + tile_id)
+     * into the int8 HWC staging tensor
+     */
+    RunStats runJobs(uint32_t first_job, uint32_t last_job, std::vector<int8_t>& staging) const;
+
+    size_t inputSize() const;
+    size_t weightSize() const;
+    size_t outputSize() const;
+};
+
+#endif // LAYER_ENGINE_H
@@ -81,6 +81,24 @@ uint32_t OutputStorage::storeOutput(uint16_t out_y, uint16_t out_x, uint16_t out
     return new_word;
 }
 
+/**
+ * Store single output value into simulated BRAM
+ */
+void OutputStorage::writeOutput(uint16_t out_y, uint16_t out_x, uint16_t out_c,
+                                int8_t value, std::vector<uint32_t>& bram) {
+    if (out_y >= config_.output_height || out_x >= config_.output_width ||
+        out_c >= config_.output_channels) {
+        throw std::out_of_range("Output coordinates out of bounds");
+    }
+
+    AddressInfo addr_info = calcOutputAddr(out_y, out_x, out_c);
+    uint32_t word = addr_info.word_addr - config_.output_base_addr;
+    if (word >= bram.size()) {
+        throw std::out_of_range("Output BRAM too small");
+    }
+    bram[word] = insertByte(bram[word], (uint8_t)value, addr_info.byte_sel);
+}
+
 /**
  * Process AXI-Stream input
  */
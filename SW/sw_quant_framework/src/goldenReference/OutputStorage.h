@@ -70,6 +70,21 @@ public:
                         int8_t value, uint32_t bram_data = 0,
                         OutputStats* stats = nullptr);
 
+    /**
+     * Store single output value directly into a simulated BRAM
+     *
+     * Same read-modify-write as storeOutput(), but reads and writes the
+     * addressed word of bram in place (word address relative to bram[0]).
+     *
+     * @param out_y Output row
+     * @param out_x Output column
+     * @param out_c Output channel
+     * @param value int8 value to store
+     * @param bram Simulated output BRAM (must cover the output tensor)
+     */
+    void writeOutput(uint16_t out_y, uint16_t out_x, uint16_t out_c,
+                     int8_t value, std::vector<uint32_t>& bram);
+
     /**
      * Process AXI-Stream input (from Dequantization pipeline)
      * 
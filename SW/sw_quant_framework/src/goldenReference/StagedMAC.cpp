@@ -58,6 +58,43 @@ StagedMAC::MACResult StagedMAC::executeCycle(int8_t input, int8_t weight, bool s
     return result;
 }
 
+/**
+ * Execute a whole pixel (closed form of count cycles + TLAST)
+ */
+int32_t StagedMAC::executePixel(const int8_t* inputs, const int8_t* weights, uint32_t count) {
+    if (count == 0) {
+        throw std::invalid_argument("Pixel must contain at least one MAC");
+    }
+
+    // Product left in the multiply stage by a previous cycle is accumulated first
+    const bool carried = pipeline_[0].valid;
+    int32_t accumulator = current_accumulator_ + (carried ? pipeline_[0].product : 0);
+
+    int32_t sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += ((int32_t)inputs[i] - config_.zero_point_in) * ((int32_t)weights[i] - config_.zero_point_weight);
+    }
+
+    // Pipeline state after count cycles: stage 1 turns valid once a product
+    // is accumulated, stage 2 holds stage 1 from one cycle earlier
+    const bool stage1_prev = pipeline_[1].valid;
+    pipeline_[2] = pipeline_[1];
+    pipeline_[2].valid = (count == 1) ? stage1_prev : (stage1_prev || carried || count > 2);
+    pipeline_[1].valid = stage1_prev || carried || count > 1;
+
+    const int32_t last_product = ((int32_t)inputs[count - 1] - config_.zero_point_in)
+                                 * ((int32_t)weights[count - 1] - config_.zero_point_weight);
+    pipeline_[0].input = inputs[count - 1];
+    pipeline_[0].weight = weights[count - 1];
+    pipeline_[0].product = last_product;
+    pipeline_[0].partial_sum = accumulator + sum - last_product;
+    pipeline_[0].valid = false;  // retired at TLAST
+
+    cycle_count_ += count;
+    current_accumulator_ = 0;
+    return accumulator + sum;
+}
+
 /**
  * Flush pipeline
  */
@@ -76,10 +113,20 @@ void StagedMAC::resetAccumulator() {
     current_accumulator_ = 0;
 }
 
+/**
+ * Retire in-flight product
+ */
+void StagedMAC::retireProduct() {
+    if (pipeline_[0].valid) {
+        current_accumulator_ += pipeline_[0].product;
+        pipeline_[0].valid = false;
+    }
+}
+
 /**
  * MACStreamProvider Constructor
  */
-MACStreamProvider::MACStreamProvider(const Config& config) : config_(config) {
+MACStreamProvider::MACStreamProvider(const Config& config) : config_(config), cycle_count_(0) {
     // Create 4 staged MAC units
     for (uint8_t i = 0; i < config.num_macs; i++) {
         StagedMAC::Config mac_config;
@@ -103,6 +150,8 @@ MACStreamProvider::Output MACStreamProvider::executeCluster(
     for (uint8_t i = 0; i < config_.num_macs; i++) {
         StagedMAC::MACResult result = macs_[i].executeCycle(inputs[i], weights[i], false);
         if (tlast) {
+            // Include this cycle's product before emitting the pixel
+            macs_[i].retireProduct();
             output.accum[i] = macs_[i].getAccumulator();
             output.valid = true;
             macs_[i].resetAccumulator();
@@ -110,6 +159,23 @@ MACStreamProvider::Output MACStreamProvider::executeCluster(
             output.accum[i] = result.accumulator;
         }
     }
+    cycle_count_++;
+
+    return output;
+}
+
+/**
+ * Execute one whole pixel across all 4 MACs
+ */
+MACStreamProvider::Output MACStreamProvider::executePixel(
+    const int8_t* const inputs[4], const int8_t* const weights[4], uint32_t count) {
+
+    Output output = {};
+    for (uint8_t i = 0; i < config_.num_macs; i++) {
+        output.accum[i] = macs_[i].executePixel(inputs[i], weights[i], count);
+    }
+    output.valid = true;
+    cycle_count_ += count;
 
     return output;
 }
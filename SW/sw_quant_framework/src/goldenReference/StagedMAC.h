@@ -70,6 +70,22 @@ public:
      */
     MACResult executeCycle(int8_t input, int8_t weight, bool start_new_pixel = false);
 
+    /**
+     * Execute a whole TLAST-delimited pixel in one call
+     *
+     * Closed-form equivalent of count executeCycle() calls where the last one
+     * carries TLAST (retireProduct(), read accumulator, resetAccumulator()).
+     * Leaves the pipeline, accumulator and cycle counter exactly as the
+     * cycle-by-cycle path would: the pixel occupies count issue cycles, and the
+     * 3-cycle latency is only paid once when the pipeline is drained.
+     *
+     * @param inputs count int8 input activations
+     * @param weights count int8 weight values
+     * @param count MACs in the pixel (must be > 0)
+     * @return Accumulator of the pixel
+     */
+    int32_t executePixel(const int8_t* inputs, const int8_t* weights, uint32_t count);
+
     /**
      * Flush pipeline and get final result
      * 
@@ -84,6 +100,15 @@ public:
      */
     void resetAccumulator();
 
+    /**
+     * Retire the product still held in the multiply stage
+     *
+     * The accumulator lags the multiply stage by one product, so on TLAST
+     * the pixel's final product must be folded in before the accumulator
+     * is read and reset; otherwise it leaks into the next pixel.
+     */
+    void retireProduct();
+
     /**
      * Get current pipeline state (for debugging)
      */
@@ -101,6 +126,13 @@ public:
      */
     int32_t getAccumulator() const { return current_accumulator_; }
 
+    /**
+     * Get number of issued cycles
+     */
+    uint32_t getCycleCount() const { return cycle_count_; }
+
+    static const uint32_t PIPELINE_LATENCY = 3;  ///< multiply -> accumulate -> register
+
 private:
     Config config_;
     std::vector<PipelineStage> pipeline_;  ///< 3 pipeline stages
@@ -151,6 +183,24 @@ public:
      */
     Output executeCluster(const int8_t inputs[4], const int8_t weights[4], bool tlast);
 
+    /**
+     * Execute one whole TLAST-delimited pixel across all 4 MACs
+     *
+     * Batched equivalent of count executeCluster() calls with TLAST on the
+     * last one; produces identical accumulators and cycle counts.
+     *
+     * @param inputs Per-MAC input streams (count values each)
+     * @param weights Per-MAC weight streams (count values each)
+     * @param count MACs per stream in this pixel
+     * @return Output from 4 MACs (always valid)
+     */
+    Output executePixel(const int8_t* const inputs[4], const int8_t* const weights[4], uint32_t count);
+
+    /**
+     * Cycles issued so far (one per executeCluster, count per executePixel)
+     */
+    uint64_t getCycleCount() const { return cycle_count_; }
+
     /**
      * Reset all accumulators for new pixel
      */
@@ -164,6 +214,7 @@ public:
 private:
     Config config_;
     std::vector<StagedMAC> macs_;
+    uint64_t cycle_count_;
 };
 
 #endif // STAGED_MAC_H
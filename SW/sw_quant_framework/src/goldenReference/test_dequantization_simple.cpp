@@ -1,6 +1,9 @@
 #include "Dequantization.h"
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
 
 int main() {
     std::cout << "\n";
@@ -11,123 +14,147 @@ int main() {
     // Test 1: Basic Q8.24 fixed-point multiplication and rounding
     std::cout << "Test 1: Q8.24 Fixed-Point Multiply with Rounding\n";
     std::cout << std::string(60, '-') << "\n";
-    
+
     Dequantization::Config config;
     config.zero_point_in = 0;
     config.zero_point_out = 0;
     config.scale_factor = 0x00800000;  // 0.5 in Q8.24
     config.enable_relu = false;
     config.enable_batch_norm = false;
-    
+
     Dequantization dequant(config);
-    
+
     // Test cases with known expected outputs
     struct TestCase {
         int32_t accumulator;
         int8_t expected_output;
         const char* description;
     };
-    
+
     TestCase tests[] = {
-        {0x00000000, 0, "Zero accumulator"},
-        {0x00800000, 1, "Accumulator = 0.5 (should round to 1)"},
-        {0x01000000, 2, "Accumulator = 1.0 (scale=0.5, so 2*0.5=1)"},
-        {0x7FFFFFFF, 127, "Max positive (saturated to 127)"},
-        {0x80000000, -128, "Min negative (saturated to -128)"},
+        {0, 0, "Zero accumulator"},
+        {1, 1, "0.5 rounds up to 1"},
+        {3, 2, "1.5 rounds up to 2"},
+        {-1, 0, "-0.5 rounds up to 0"},
+        {-3, -1, "-1.5 rounds up to -1"},
+        {1000, 127, "500 saturates to 127"},
+        {-1000, -128, "-500 saturates to -128"},
     };
-    
+
     bool all_pass = true;
-    
-    for (int i = 0; i < 5; i++) {
-        dequant.resetPipeline();
-        
-        // Process through 5-stage pipeline
-        for (int stage = 0; stage < 5; stage++) {
-            if (stage == 0) {
-                dequant.executeCycle(tests[i].accumulator);
-            } else {
-                dequant.executeCycle(0);
-            }
-        }
-        
-        int8_t output = dequant.getLatestOutput();
-        bool pass = (output == tests[i].expected_output);
+
+    for (const TestCase& test : tests) {
+        int8_t output = dequant.dequantizeScalar(test.accumulator);
+        bool pass = (output == test.expected_output);
         all_pass = all_pass && pass;
-        
-        std::cout << "  " << tests[i].description << "\n";
-        std::cout << "    Input (hex): 0x" << std::hex << std::setfill('0') << std::setw(8) 
-                  << (tests[i].accumulator & 0xFFFFFFFF) << std::dec << "\n";
-        std::cout << "    Expected: " << (int)tests[i].expected_output 
+
+        std::cout << "  " << test.description << "\n";
+        std::cout << "    Input (hex): 0x" << std::hex << std::setfill('0') << std::setw(8)
+                  << ((uint32_t)test.accumulator & 0xFFFFFFFF) << std::dec << std::setfill(' ') << "\n";
+        std::cout << "    Expected: " << (int)test.expected_output
                   << ", Got: " << (int)output << " ";
         std::cout << (pass ? "[PASS]" : "[FAIL]") << "\n\n";
     }
-    
+
     // Test 2: ReLU activation
     std::cout << "Test 2: ReLU Activation\n";
     std::cout << std::string(60, '-') << "\n";
-    
-    Dequantization::Config relu_config;
-    relu_config.zero_point_in = 0;
-    relu_config.zero_point_out = 0;
-    relu_config.scale_factor = 0x00800000;
+
+    Dequantization::Config relu_config = config;
+    relu_config.zero_point_out = -128;
     relu_config.enable_relu = true;
-    relu_config.enable_batch_norm = false;
-    
+
     Dequantization dequant_relu(relu_config);
-    
-    // Negative accumulator should become 0 with ReLU
-    dequant_relu.resetPipeline();
-    for (int stage = 0; stage < 5; stage++) {
-        if (stage == 0) {
-            dequant_relu.executeCycle(0xFFFFFFFF);  // Negative value
-        } else {
-            dequant_relu.executeCycle(0);
-        }
-    }
-    
-    int8_t relu_output = dequant_relu.getLatestOutput();
-    bool relu_pass = (relu_output == 0);  // ReLU should clamp to 0
+
+    // ReLU runs before the output zero-point, so negative values map to zero_point_out
+    int8_t relu_output = dequant_relu.dequantizeScalar(-1000);
+    bool relu_pass = (relu_output == -128);
     all_pass = all_pass && relu_pass;
-    
-    std::cout << "  Negative accumulator with ReLU enabled\n";
-    std::cout << "    Input: 0xFFFFFFFF (negative)\n";
-    std::cout << "    Expected: 0 (ReLU clamps negative to 0)\n";
+
+    std::cout << "  Negative accumulator with ReLU enabled, zero_point_out = -128\n";
+    std::cout << "    Input: -1000\n";
+    std::cout << "    Expected: -128 (ReLU clamps to 0, then zero-point)\n";
     std::cout << "    Got: " << (int)relu_output << " " << (relu_pass ? "[PASS]" : "[FAIL]") << "\n\n";
-    
-    // Test 3: Pipeline latency
-    std::cout << "Test 3: 5-Stage Pipeline Latency\n";
+
+    // Test 3: Bulk requantizer vs per-element pipeline
+    std::cout << "Test 3: Bulk Requantization Bit-Exactness\n";
     std::cout << std::string(60, '-') << "\n";
-    
-    Dequantization dequant_latency(config);
-    
-    // Insert value at stage 0, should appear at output after 5 cycles
-    dequant_latency.resetPipeline();
-    dequant_latency.executeCycle(0x00800000);  // Cycle 0: input
-    
-    std::cout << "  After cycle 0 (input): output = " << (int)dequant_latency.getLatestOutput() << "\n";
-    
-    int8_t output_after_5 = 0;
-    for (int i = 1; i <= 5; i++) {
-        dequant_latency.executeCycle(0);
-        output_after_5 = dequant_latency.getLatestOutput();
-        std::cout << "  After cycle " << i << ": output = " << (int)output_after_5 << "\n";
+
+    std::srand(42);
+    std::vector<int32_t> accumulators(1003);  // Not a multiple of the SIMD width
+    for (size_t i = 0; i < accumulators.size(); i++) {
+        int32_t value = (int32_t)(((uint32_t)std::rand() << 16) ^ (uint32_t)std::rand());
+        // Mix full-range values with values near the int8 window
+        accumulators[i] = (i % 3 == 0) ? value : (value % 200000);
     }
-    
-    bool latency_pass = (output_after_5 == 1);  // 0x00800000 * 0.5 = 0.5 -> rounds to 1
-    all_pass = all_pass && latency_pass;
-    std::cout << "  Expected output at cycle 5: 1, Got: " << (int)output_after_5 
-              << " " << (latency_pass ? "[PASS]" : "[FAIL]") << "\n\n";
-    
+    accumulators[0] = INT32_MIN;
+    accumulators[1] = INT32_MAX;
+    accumulators[2] = 0;
+    accumulators[3] = -1;
+
+    struct BulkCase {
+        int32_t zero_point_in;
+        int32_t zero_point_out;
+        int32_t scale_factor;
+        bool enable_relu;
+    };
+
+    BulkCase bulk_cases[] = {
+        {0, 0, 0x00800000, false},
+        {0, -128, 0x00004000, true},
+        {-7, -128, 0x00001234, true},
+        {12345, 5, 0x01000000, false},
+        {0, 0, 0x7FFFFFFF, true},
+        {-300, 3, (int32_t)0xFF000000, false},  // Negative scale
+    };
+
+    for (const BulkCase& bc : bulk_cases) {
+        Dequantization::Config bulk_config = {bc.zero_point_in, bc.zero_point_out, bc.scale_factor,
+                                              bc.enable_relu, false};
+        Dequantization bulk(bulk_config);
+
+        std::vector<int8_t> expected(accumulators.size());
+        for (size_t i = 0; i < accumulators.size(); i++) {
+            expected[i] = bulk.dequantizePipelined(accumulators[i]).final;
+        }
+
+        // Out of place
+        std::vector<int8_t> outputs(accumulators.size());
+        bulk.dequantizeBuffer(accumulators.data(), outputs.data(), accumulators.size());
+
+        // In place: int8 results overwrite the front of the int32 buffer
+        std::vector<int32_t> in_place = accumulators;
+        int8_t* in_place_out = reinterpret_cast<int8_t*>(in_place.data());
+        bulk.dequantizeBuffer(in_place.data(), in_place_out, in_place.size());
+
+        // Vector API without and with stats
+        std::vector<int8_t> fast = bulk.dequantizeVector(accumulators);
+        std::vector<Dequantization::OutputStats> stats;
+        std::vector<int8_t> slow = bulk.dequantizeVector(accumulators, &stats);
+
+        bool pass = outputs == expected &&
+                    std::memcmp(in_place_out, expected.data(), expected.size()) == 0 &&
+                    fast == expected && slow == expected && stats.size() == accumulators.size();
+        all_pass = all_pass && pass;
+
+        std::cout << "  zp_in=" << bc.zero_point_in << " zp_out=" << bc.zero_point_out
+                  << " scale=0x" << std::hex << std::setfill('0') << std::setw(8)
+                  << (uint32_t)bc.scale_factor << std::dec << std::setfill(' ')
+                  << " relu=" << (bc.enable_relu ? "on" : "off")
+                  << ": " << (pass ? "[PASS]" : "[FAIL]") << "\n";
+    }
+    std::cout << "\n";
+
     if (!all_pass) {
         std::cout << "======================================================================\n";
         std::cout << "[FAIL] SOME DEQUANTIZATION TESTS FAILED\n";
         std::cout << "======================================================================\n\n";
         return 1;
     }
-    
+
     std::cout << "======================================================================\n";
     std::cout << "[PASS] ALL DEQUANTIZATION TESTS PASSED\n";
     std::cout << "======================================================================\n\n";
-    
+
     return 0;
 }
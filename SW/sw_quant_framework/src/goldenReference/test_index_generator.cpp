@@ -1,6 +1,7 @@
 #include "IndexGenerator.h"
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 int main() {
     std::cout << "====================================\n";
@@ -87,11 +88,45 @@ int main() {
         std::cout << "Generating all addresses and verifying...\n";
         auto all_addresses = gen.generateAllAddresses();
         
-        if (gen.verifyAddresses(all_addresses)) {
+        if (!gen.verifyAddresses(all_addresses)) {
+            std::cout << "\n Verification FAILED!\n";
+            return 1;
+        }
+
+        // Streaming: odd-sized spans must reproduce the full address vector
+        std::cout << "\nStreaming AddressStream in spans of 37...\n";
+        IndexGenerator::AddressStream addr_stream = gen.stream();
+        std::vector<IndexGenerator::Address> span(37);
+        size_t streamed = 0;
+        bool stream_ok = true;
+        while (!addr_stream.done()) {
+            size_t n = addr_stream.fill(span.data(), span.size());
+            for (size_t i = 0; i < n && stream_ok; i++) {
+                const IndexGenerator::Address& a = span[i];
+                const IndexGenerator::Address& b = all_addresses[streamed + i];
+                stream_ok = (a.input_addr == b.input_addr && a.weight_addr == b.weight_addr &&
+                             a.tlast == b.tlast && a.oc == b.oc);
+            }
+            streamed += n;
+        }
+        stream_ok = stream_ok && streamed == all_addresses.size() &&
+                    addr_stream.position() == all_addresses.size();
+        std::cout << "  Streamed " << streamed << " addresses: " << (stream_ok ? "MATCH" : "MISMATCH") << "\n";
+
+        // Resume: skip + reset land on the expected addresses
+        addr_stream.reset();
+        IndexGenerator::Address resumed;
+        uint64_t skip_to = all_addresses.size() / 3 + 11;
+        bool resume_ok = addr_stream.skip(skip_to) == skip_to && addr_stream.next(resumed) &&
+                         resumed.input_addr == all_addresses[skip_to].input_addr &&
+                         resumed.weight_addr == all_addresses[skip_to].weight_addr;
+        std::cout << "  Skip/resume at " << skip_to << ": " << (resume_ok ? "MATCH" : "MISMATCH") << "\n";
+
+        if (stream_ok && resume_ok) {
             std::cout << "\n [PASS] All tests PASSED!\n";
             return 0;
         } else {
-            std::cout << "\n Verification FAILED!\n";
+            std::cout << "\n Streaming verification FAILED!\n";
             return 1;
         }
 
@@ -0,0 +1,146 @@
+#include "LayerEngine.h"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+/**
+ * Direct integer convolution used as the expected result
+ * (HWC input, HWIO weights, stride 1, no padding)
+ */
+static std::vector<int8_t> referenceConv(const std::vector<int8_t>& input,
+                                         const std::vector<int8_t>& weights_hwio,
+                                         const std::vector<int32_t>& biases,
+                                         const LayerEngine::Config& cfg) {
+    const IndexGenerator::ConvConfig& c = cfg.conv;
+    const int H = c.input_height, W = c.input_width, C = c.input_channels;
+    const int R = c.filter_height, S = c.filter_width, M = c.num_filters;
+    const int P = H - R + 1, Q = W - S + 1;
+
+    Dequantization::Config dq_config = {0, cfg.zero_point_out, cfg.scale_factor, cfg.enable_relu, false};
+    Dequantization dequant(dq_config);
+
+    std::vector<int8_t> out((size_t)P * Q * M);
+    for (int p = 0; p < P; p++) {
+        for (int q = 0; q < Q; q++) {
+            for (int m = 0; m < M; m++) {
+                int32_t acc = 0;
+                for (int r = 0; r < R; r++) {
+                    for (int s = 0; s < S; s++) {
+                        for (int ch = 0; ch < C; ch++) {
+                            int32_t x = input[((p + r) * W + (q + s)) * C + ch] - cfg.zero_point_in;
+                            int32_t w = weights_hwio[((r * S + s) * C + ch) * M + m];
+                            acc += x * w;
+                        }
+                    }
+                }
+                dequant.setQuantParams(-biases[m], cfg.zero_point_out, cfg.scale_factor);
+                out[((size_t)p * Q + q) * M + m] = dequant.dequantizeScalar(acc);
+            }
+        }
+    }
+    return out;
+}
+
+static bool runCase(const char* name, uint16_t H, uint16_t W, uint16_t C, uint8_t M, uint16_t tile_size,
+                    uint32_t num_threads) {
+    std::cout << "Test: " << name << " (" << H << "x" << W << "x" << C << " -> " << (int)M
+              << " 3x3 filters, tile " << tile_size << ", " << num_threads << " threads)\n";
+    std::cout << std::string(60, '-') << "\n";
+
+    LayerEngine::Config cfg = {};
+    cfg.conv.input_height = H;
+    cfg.conv.input_width = W;
+    cfg.conv.input_channels = C;
+    cfg.conv.filter_height = 3;
+    cfg.conv.filter_width = 3;
+    cfg.conv.num_filters = M;
+    cfg.conv.stride = 1;
+    cfg.conv.padding = 0;
+    cfg.tile_size = tile_size;
+    cfg.zero_point_in = -7;
+    cfg.zero_point_out = -128;
+    cfg.scale_factor = 0x00004000;  // 1/1024 in Q8.24
+    cfg.enable_relu = true;
+    cfg.num_threads = num_threads;
+
+    std::srand(1234);
+    std::vector<int8_t> input((size_t)H * W * C);
+    std::vector<int8_t> weights((size_t)9 * C * M);
+    std::vector<int32_t> biases(M);
+    for (size_t i = 0; i < input.size(); i++) input[i] = (int8_t)(std::rand() % 256 - 128);
+    for (size_t i = 0; i < weights.size(); i++) weights[i] = (int8_t)(std::rand() % 255 - 127);
+    for (size_t i = 0; i < biases.size(); i++) biases[i] = std::rand() % 20001 - 10000;
+
+    LayerEngine engine(cfg);
+    std::vector<int8_t> packed(weights.size());
+    LayerEngine::packWeightsHWIO(weights.data(), packed.data(), 3, 3, C, M);
+    engine.loadInput(input.data(), input.size());
+    engine.loadWeights(packed.data(), packed.size());
+    engine.loadBiases(biases.data(), biases.size());
+
+    cfg.num_threads = 1;
+    LayerEngine engine_serial(cfg);
+    engine_serial.loadInput(input.data(), input.size());
+    engine_serial.loadWeights(packed.data(), packed.size());
+    engine_serial.loadBiases(biases.data(), biases.size());
+    LayerEngine::RunStats serial_stats = engine_serial.start();
+
+    LayerEngine::RunStats stats = engine.start();
+    bool threads_ok = engine.getOutputBRAM() == engine_serial.getOutputBRAM() &&
+                      stats.cycles == serial_stats.cycles && stats.macs == serial_stats.macs;
+
+    const IndexGenerator::ConvConfig& conv = engine.getConfig().conv;
+    std::vector<int8_t> output((size_t)conv.output_height * conv.output_width * M);
+    engine.readOutput(output.data(), output.size());
+
+    std::vector<int8_t> expected = referenceConv(input, weights, biases, cfg);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < output.size(); i++) {
+        if (output[i] != expected[i]) {
+            if (mismatches < 5) {
+                std::cout << "  Mismatch at " << i << ": got " << (int)output[i]
+                          << ", expected " << (int)expected[i] << "\n";
+            }
+            mismatches++;
+        }
+    }
+
+    uint64_t expected_macs = (uint64_t)conv.output_height * conv.output_width * M * conv.macs_per_pixel;
+    bool macs_ok = (stats.macs == expected_macs);
+
+    std::cout << "  Cycles: " << stats.cycles << ", MACs: " << stats.macs
+              << " (expected " << expected_macs << ")\n";
+    std::cout << "  Mismatches: " << mismatches << " / " << output.size() << "\n";
+    std::cout << "  " << stats.threads << " threads vs serial: " << (threads_ok ? "IDENTICAL" : "DIFFERENT") << "\n";
+    bool pass = (mismatches == 0) && macs_ok && threads_ok;
+    std::cout << "  Result: " << (pass ? "[PASS]" : "[FAIL]") << "\n\n";
+    return pass;
+}
+
+int main() {
+    std::cout << "\n";
+    std::cout << "======================================================================\n";
+    std::cout << "LAYER ENGINE TEST - Whole-Layer Execution vs Direct Convolution\n";
+    std::cout << "======================================================================\n\n";
+
+    try {
+        // Channel count divisible by 4, output smaller than one tile
+        if (!runCase("Single tile", 10, 10, 3, 8, 16, 2)) return 1;
+
+        // Partial tiles and a partial last oc batch
+        if (!runCase("Partial tiles and oc batch", 21, 19, 5, 6, 8, 3)) return 1;
+
+        // Many workers, channel count not a multiple of 4 (oc batches share BRAM words)
+        if (!runCase("Worker pool", 34, 30, 7, 11, 8, 16)) return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "======================================================================\n";
+    std::cout << "[PASS] ALL LAYER ENGINE TESTS PASSED\n";
+    std::cout << "======================================================================\n\n";
+
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "StagedMAC.h"
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <cstdlib>
 
 int main() {
     std::cout << "\n";
@@ -117,6 +119,66 @@ int main() {
     
     if (!pixel1_ok || !pixel2_ok) return 1;
     
+    // Test 4: Batched pixel execution vs cycle-by-cycle cluster
+    std::cout << "Test 4: Batched Pixel Execution (MACStreamProvider)\n";
+    std::cout << std::string(60, '-') << "\n";
+    
+    MACStreamProvider::Config cluster_config;
+    cluster_config.num_macs = 4;
+    cluster_config.zero_point_in = -7;
+    cluster_config.zero_point_weight = 2;
+    
+    MACStreamProvider per_cycle(cluster_config);
+    MACStreamProvider batched(cluster_config);
+    
+    std::srand(42);
+    int pixel_mismatches = 0;
+    for (int pixel = 0; pixel < 200; pixel++) {
+        uint32_t count = 1 + std::rand() % 80;
+        std::vector<int8_t> in[4], wt[4];
+        const int8_t* in_ptr[4];
+        const int8_t* wt_ptr[4];
+        for (int m = 0; m < 4; m++) {
+            for (uint32_t k = 0; k < count; k++) {
+                in[m].push_back((int8_t)(std::rand() % 256 - 128));
+                wt[m].push_back((int8_t)(std::rand() % 256 - 128));
+            }
+            in_ptr[m] = in[m].data();
+            wt_ptr[m] = wt[m].data();
+        }
+        
+        MACStreamProvider::Output expected = {};
+        for (uint32_t k = 0; k < count; k++) {
+            int8_t cycle_in[4], cycle_wt[4];
+            for (int m = 0; m < 4; m++) {
+                cycle_in[m] = in[m][k];
+                cycle_wt[m] = wt[m][k];
+            }
+            expected = per_cycle.executeCluster(cycle_in, cycle_wt, k == count - 1);
+        }
+        MACStreamProvider::Output got = batched.executePixel(in_ptr, wt_ptr, count);
+        
+        for (int m = 0; m < 4; m++) {
+            const std::vector<StagedMAC::PipelineStage>& a = per_cycle.getMAC(m).getPipelineState();
+            const std::vector<StagedMAC::PipelineStage>& b = batched.getMAC(m).getPipelineState();
+            bool same = expected.accum[m] == got.accum[m] &&
+                        per_cycle.getMAC(m).getCycleCount() == batched.getMAC(m).getCycleCount();
+            for (int st = 0; st < 3; st++) {
+                same = same && a[st].valid == b[st].valid && a[st].product == b[st].product &&
+                       a[st].partial_sum == b[st].partial_sum;
+            }
+            if (!same) pixel_mismatches++;
+        }
+    }
+    bool batch_ok = (pixel_mismatches == 0) && per_cycle.getCycleCount() == batched.getCycleCount();
+    
+    std::cout << "  200 pixels (1-80 MACs), cycles: " << per_cycle.getCycleCount() 
+              << " per-cycle vs " << batched.getCycleCount() << " batched\n";
+    std::cout << "  Mismatching MAC states: " << pixel_mismatches << "\n";
+    std::cout << "  Result: " << (batch_ok ? "[PASS]" : "[FAIL]") << "\n\n";
+    
+    if (!batch_ok) return 1;
+    
     std::cout << "======================================================================\n";
     std::cout << "[PASS] ALL STAGED MAC TESTS PASSED\n";
     std::cout << "======================================================================\n\n";
@@ -0,0 +1,243 @@
+#include "BlockSparse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifndef ZEDBOARD
+#include <fstream>
+#endif
+
+namespace ML {
+
+namespace {
+
+const char BSR_MAGIC[4] = {'B', 'S', 'R', '1'};
+
+// Sequential reads of one file; a short read is a malformed file
+class BinaryReader {
+   public:
+    explicit BinaryReader(const Path& path) : path(path) {
+#ifdef ZEDBOARD
+        opened = f_open(&file, path.c_str(), FA_OPEN_EXISTING | FA_READ) == FR_OK;
+#else
+        file.open(path, std::ios::binary);
+        opened = file.is_open();
+#endif
+    }
+    ~BinaryReader() {
+#ifdef ZEDBOARD
+        if (opened) f_close(&file);
+#endif
+    }
+
+    bool isOpen() const { return opened; }
+
+    void read(void* dst, std::size_t bytes) {
+#ifdef ZEDBOARD
+        UINT bytesRead = 0;
+        if (f_read(&file, dst, bytes, &bytesRead) != FR_OK || bytesRead != bytes) {
+#else
+        if (!file.read(static_cast<char*>(dst), bytes)) {
+#endif
+            throw std::runtime_error("Truncated block-sparse weight file: " + path);
+        }
+    }
+
+   private:
+    Path path;
+    bool opened = false;
+#ifdef ZEDBOARD
+    FIL file;
+#else
+    std::ifstream file;
+#endif
+};
+
+class BinaryWriter {
+   public:
+    explicit BinaryWriter(const Path& path) : path(path) {
+#ifdef ZEDBOARD
+        if (f_open(&file, path.c_str(), FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+#else
+        file.open(path, std::ios::binary);
+        if (!file.is_open()) {
+#endif
+            throw std::runtime_error("Failed to open block-sparse weight file for writing: " + path);
+        }
+    }
+    ~BinaryWriter() {
+#ifdef ZEDBOARD
+        f_close(&file);
+#endif
+    }
+
+    void write(const void* src, std::size_t bytes) {
+#ifdef ZEDBOARD
+        UINT bytesWritten = 0;
+        if (f_write(&file, src, bytes, &bytesWritten) != FR_OK || bytesWritten != bytes) {
+#else
+        if (!file.write(static_cast<const char*>(src), bytes)) {
+#endif
+            throw std::runtime_error("Failed to write block-sparse weight file: " + path);
+        }
+    }
+
+   private:
+    Path path;
+#ifdef ZEDBOARD
+    FIL file;
+#else
+    std::ofstream file;
+#endif
+};
+
+}  // namespace
+
+const std::size_t BlockSparseWeights::BLOCK;  // Odr-used by std::min (C++11 needs the definition)
+
+BlockSparseWeights BlockSparseWeights::fromDense(const fp32* weights, std::size_t rows, std::size_t cols) {
+    BlockSparseWeights result;
+    result.rows = rows;
+    result.cols = cols;
+    result.rowStart.reserve(rows + 1);
+    for (std::size_t row = 0; row < rows; row++) {
+        result.rowStart.push_back(static_cast<ui32>(result.blockCol.size()));
+        const fp32* w = weights + row * cols;
+        for (std::size_t block = 0; block < result.blocksPerRow(); block++) {
+            const std::size_t first = block * BLOCK, last = std::min(cols, first + BLOCK);
+            if (std::all_of(w + first, w + last, [](fp32 v) { return v == 0.0f; })) continue;
+            result.blockCol.push_back(static_cast<ui16>(block));
+            result.values.insert(result.values.end(), w + first, w + last);
+            result.values.resize(result.blockCol.size() * BLOCK, 0.0f);
+        }
+    }
+    result.rowStart.push_back(static_cast<ui32>(result.blockCol.size()));
+    return result;
+}
+
+void BlockSparseWeights::toDense(fp32* weights) const {
+    std::fill(weights, weights + rows * cols, 0.0f);
+    for (std::size_t row = 0; row < rows; row++) {
+        for (ui32 b = rowStart[row]; b < rowStart[row + 1]; b++) {
+            const std::size_t first = blockCol[b] * BLOCK, count = std::min(BLOCK, cols - first);
+            std::copy(values.data() + b * BLOCK, values.data() + b * BLOCK + count, weights + row * cols + first);
+        }
+    }
+}
+
+bool BlockSparseWeights::load(const Path& path) {
+    BinaryReader in(path);
+    if (!in.isOpen()) return false;
+
+    char magic[4];
+    ui32 header[4];  // rows, cols, block, blocks
+    in.read(magic, sizeof(magic));
+    in.read(header, sizeof(header));
+    if (std::memcmp(magic, BSR_MAGIC, sizeof(magic)) != 0 || header[2] != BLOCK) {
+        throw std::runtime_error("Not a block-sparse weight file with " + std::to_string(BLOCK) + "-wide blocks: " + path);
+    }
+
+    rows = header[0];
+    cols = header[1];
+    rowStart.resize(rows + 1);
+    blockCol.resize(header[3]);
+    values.resize(blockCol.size() * BLOCK);
+    in.read(rowStart.data(), rowStart.size() * sizeof(ui32));
+    in.read(blockCol.data(), blockCol.size() * sizeof(ui16));
+    in.read(values.data(), values.size() * sizeof(fp32));
+
+    for (std::size_t row = 0; row < rows; row++) {
+        if (rowStart[row] > rowStart[row + 1]) throw std::runtime_error("Corrupt block rows in " + path);
+    }
+    if (rowStart[0] != 0 || rowStart[rows] != blockCol.size()) {
+        throw std::runtime_error("Corrupt block rows in " + path);
+    }
+    for (ui16 col : blockCol) {
+        if (col >= blocksPerRow()) throw std::runtime_error("Block column out of range in " + path);
+    }
+    std::cout << "Opened block-sparse file " << path << " (" << blockCount() << " blocks, "
+              << static_cast<int>(100.0 * density() + 0.5) << "% dense)" << std::endl;
+    return true;
+}
+
+void BlockSparseWeights::save(const Path& path) const {
+    BinaryWriter out(path);
+    const ui32 header[4] = {static_cast<ui32>(rows), static_cast<ui32>(cols), static_cast<ui32>(BLOCK),
+                            static_cast<ui32>(blockCount())};
+    out.write(BSR_MAGIC, sizeof(BSR_MAGIC));
+    out.write(header, sizeof(header));
+    out.write(rowStart.data(), rowStart.size() * sizeof(ui32));
+    out.write(blockCol.data(), blockCol.size() * sizeof(ui16));
+    out.write(values.data(), values.size() * sizeof(fp32));
+}
+
+double BlockSparseWeights::density() const {
+    const std::size_t total = rows * blocksPerRow();
+    return total ? static_cast<double>(blockCount()) / total : 1.0;
+}
+
+std::size_t BlockSparseWeights::fileBytes() const {
+    return sizeof(BSR_MAGIC) + 4 * sizeof(ui32) + rowStart.size() * sizeof(ui32) + blockCol.size() * sizeof(ui16) +
+           values.size() * sizeof(fp32);
+}
+
+std::size_t pruneBlocks(fp32* weights, std::size_t rows, std::size_t cols, float sparsity) {
+    const std::size_t blocksPerRow = (cols + BlockSparseWeights::BLOCK - 1) / BlockSparseWeights::BLOCK;
+    std::vector<std::pair<double, std::size_t>> norms;  // (squared L2 norm, block index)
+    norms.reserve(rows * blocksPerRow);
+    for (std::size_t row = 0; row < rows; row++) {
+        for (std::size_t block = 0; block < blocksPerRow; block++) {
+            const std::size_t first = block * BlockSparseWeights::BLOCK;
+            const std::size_t last = std::min(cols, first + BlockSparseWeights::BLOCK);
+            double norm = 0.0;
+            for (std::size_t col = first; col < last; col++) {
+                norm += static_cast<double>(weights[row * cols + col]) * weights[row * cols + col];
+            }
+            norms.emplace_back(norm, row * blocksPerRow + block);
+        }
+    }
+
+    const std::size_t prune = std::min(norms.size(), static_cast<std::size_t>(std::round(sparsity * norms.size())));
+    std::nth_element(norms.begin(), norms.begin() + prune, norms.end());
+    for (std::size_t i = 0; i < prune; i++) {
+        const std::size_t row = norms[i].second / blocksPerRow;
+        const std::size_t first = norms[i].second % blocksPerRow * BlockSparseWeights::BLOCK;
+        const std::size_t last = std::min(cols, first + BlockSparseWeights::BLOCK);
+        std::fill(weights + row * cols + first, weights + row * cols + last, 0.0f);
+    }
+    return prune;
+}
+
+Path compressedWeightsPath(const Path& densePath) {
+    const std::size_t dot = densePath.rfind('.');
+    const std::size_t slash = densePath.rfind('/');
+    const bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    return Path((hasExtension ? densePath.substr(0, dot) : std::string(densePath)) + ".bsr");
+}
+
+BlockSparseWeights loadLayerWeights(LayerData& weights, std::size_t rows, std::size_t cols) {
+    const Path& densePath = weights.getParams().filePath;
+    BlockSparseWeights sparse;
+    if (sparse.load(compressedWeightsPath(densePath))) {
+        if (sparse.getRows() != rows || sparse.getCols() != cols) {
+            throw std::runtime_error("Block-sparse weights of " + densePath + " are " + std::to_string(sparse.getRows()) +
+                                     " x " + std::to_string(sparse.getCols()) + ", expected " + std::to_string(rows) +
+                                     " x " + std::to_string(cols));
+        }
+        weights.allocData();
+        sparse.toDense(static_cast<fp32*>(weights.raw()));
+    } else {
+        weights.loadData();
+        sparse = BlockSparseWeights::fromDense(static_cast<const fp32*>(weights.raw()), rows, cols);
+    }
+
+    if (sparse.density() >= Config::BLOCK_SPARSE_DENSITY_THRESHOLD) return BlockSparseWeights();
+    ML_LOG_INFO("Block-sparse weights for " + densePath + ": " + std::to_string(sparse.blockCount()) + " of " +
+                std::to_string(rows * sparse.blocksPerRow()) + " blocks");
+    return sparse;
+}
+
+}  // namespace ML
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../BufferPool.h"
+#include "../Types.h"
+#include "../Utils.h"
+#include "Layer.h"
+
+namespace ML {
+
+// Block-sparse weight matrix for structurally pruned conv and dense layers.
+// Rows are the inputs of the layer (conv taps (r, s, c) in HWIO order, or dense input
+// features), columns its N outputs. Weights are grouped into 1 x BLOCK blocks of
+// consecutive outputs and only blocks with a nonzero weight are kept, row by row (block CSR):
+// row k owns blocks [rowStart[k], rowStart[k + 1]); block b covers outputs
+// [blockCol[b] * BLOCK, +BLOCK) with values [b * BLOCK, +BLOCK), the last block zero padded.
+// A kernel multiplies each input only with the blocks of its row, one vector MAC per block,
+// and an accelerator can stream the same blocks as stationary weights.
+//
+// On disk (.bsr, little endian): "BSR1", then rows, cols, BLOCK and the block count as
+// ui32, rowStart (rows + 1 x ui32), blockCol (ui16 per block) and the fp32 values.
+class BlockSparseWeights {
+   public:
+    static const std::size_t BLOCK = 16;
+
+    // Keep the blocks of a dense [rows][cols] matrix that hold a nonzero weight
+    static BlockSparseWeights fromDense(const fp32* weights, std::size_t rows, std::size_t cols);
+
+    // Expand into a dense [rows][cols] matrix
+    void toDense(fp32* weights) const;
+
+    // Read a .bsr file: false if it cannot be opened, throws if it is malformed
+    bool load(const Path& path);
+    void save(const Path& path) const;
+
+    bool empty() const { return rowStart.empty(); }
+    std::size_t getRows() const { return rows; }
+    std::size_t getCols() const { return cols; }
+    std::size_t blockCount() const { return blockCol.size(); }
+    std::size_t blocksPerRow() const { return (cols + BLOCK - 1) / BLOCK; }
+    double density() const;       // Kept blocks / all blocks
+    std::size_t fileBytes() const;  // Size of the .bsr file
+
+    const ui32* getRowStart() const { return rowStart.data(); }
+    const ui16* getBlockCol() const { return blockCol.data(); }
+    const fp32* getValues() const { return values.data(); }
+
+   private:
+    std::size_t rows = 0, cols = 0;
+    std::vector<ui32> rowStart;
+    std::vector<ui16> blockCol;
+    AlignedVector<fp32> values;
+};
+
+// Structured magnitude pruning: zero the fraction `sparsity` of the 1 x BLOCK blocks of a
+// dense [rows][cols] matrix with the smallest L2 norm. Returns the number of blocks zeroed.
+std::size_t pruneBlocks(fp32* weights, std::size_t rows, std::size_t cols, float sparsity);
+
+// The compressed file a layer loads instead of a dense one: "conv3_weights.bin" -> "conv3_weights.bsr"
+Path compressedWeightsPath(const Path& densePath);
+
+// Load the [rows][cols] weights of a conv or dense layer into `weights`: expanded from the
+// .bsr file next to the dense one if there is one, else the dense file itself. Returns the
+// block-sparse form when fewer than Config::BLOCK_SPARSE_DENSITY_THRESHOLD of the blocks are
+// kept (the kernels then skip the others), else an empty one.
+BlockSparseWeights loadLayerWeights(LayerData& weights, std::size_t rows, std::size_t cols);
+
+}  // namespace ML
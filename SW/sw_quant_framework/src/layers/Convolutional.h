@@ -2,6 +2,7 @@
 
 #include "../Types.h"
 #include "../Utils.h"
+#include "BlockSparse.h"
 #include "Layer.h"
 
 namespace ML {
@@ -23,8 +24,11 @@ class ConvolutionalLayer : public Layer {
     // Allocate all resources needed for the layer & Load all of the required data for the layer
     virtual void allocLayer() override {
         Layer::allocLayer();
-        weightData.loadData();
+        const std::vector<std::size_t>& w = weightParam.dims;
+        sparseWeights = loadLayerWeights(weightData, w[0] * w[1] * w[2], w[3]);  // .bsr if pruned
         biasData.loadData();
+        transformWinogradWeights();
+        packInt4Weights();
     }
 
     // Fre all resources allocated for the layer
@@ -32,6 +36,9 @@ class ConvolutionalLayer : public Layer {
         Layer::freeLayer();
         weightData.freeData();
         biasData.freeData();
+        winogradWeights.clear();
+        sparseWeights = BlockSparseWeights();
+        int4Weights.clear();
     }
 
     // Virtual functions
@@ -40,17 +47,90 @@ class ConvolutionalLayer : public Layer {
     virtual void computeTiled(const LayerData& dataIn) const override;
     virtual void computeSIMD(const LayerData& dataIn) const override;
     virtual void computeQuantized(const LayerData& dataIn) const override;
+    virtual void computeAccelerated(const LayerData& dataIn) const override;
+
+    // fp32 convolution (+ ReLU) of output rows [firstRow, lastRow) only; computeNaive runs all
+    // rows. Lets a fused conv+pool node consume each band of rows while it is still in cache.
+    void computeRows(const LayerData& dataIn, size_t firstRow, size_t lastRow) const;
+
+    // Same rows through computeTiled: Winograd F(2x2, 3x3) on 3x3 layers, else computeRows.
+    // Bands starting on an even row cover whole 2x2 output tiles.
+    void computeTiledRows(const LayerData& dataIn, size_t firstRow, size_t lastRow) const;
+    bool usesWinograd() const { return !winogradWeights.empty(); }
+
+    // Same rows through computeSIMD: pixel-major, vectorized over the output channels, and
+    // over the kept weight blocks only when the layer is block-sparse
+    void computeSIMDRows(const LayerData& dataIn, size_t firstRow, size_t lastRow) const;
+    bool usesBlockSparse() const { return !sparseWeights.empty(); }
+
+    // Run a pruned layer on all of its weights (false), or on the kept blocks again if they
+    // are sparse enough (see loadLayerWeights); lets tests compare the two kernels
+    void setBlockSparse(bool enabled);
+
+    // int4 layers keep their quantized weights packed two per byte and the quantized paths
+    // MAC straight from them, instead of quantizing the fp32 weights per call (repacked if
+    // allocated). The fp32 weights stay for the other inference types.
+    virtual void setWeightBits(unsigned bits) override;
+    virtual double weightQuantizationError(unsigned bits) const override;
+
+    // Fixed int8 input quantization ix = round(Si * Ix) + zi and output range [0, outputMax]
+    // (for the layer engine) in place of the calibration file; Si = 0 goes back to the file
+    void setInputQuantization(fp32 Si, i8 zi, fp32 outputMax) {
+        fixedSi = Si;
+        fixedZi = zi;
+        fixedOutputMax = outputMax;
+    }
+
+    // int8 input, weights and biases, plus the layer engine's packed weights and output
+    // (or the software MAC accumulators and sparse input lists)
+    virtual std::size_t getWorkspaceSize() const override;
+
+    // P*Q*M output pixels times R*S*C taps (times the kept fraction of a block-sparse layer)
+    virtual std::size_t getMacs() const override {
+        const std::vector<std::size_t>& w = weightParam.dims;
+        const std::size_t macs = getOutputParams().flat_count() * w[0] * w[1] * w[2];
+        return usesBlockSparse() ? static_cast<std::size_t>(macs * sparseWeights.density()) : macs;
+    }
+    virtual std::size_t getWeightBytes() const override {
+        return (usesBlockSparse() ? sparseWeights.fileBytes() : weightParam.byte_size()) + biasParam.byte_size();
+    }
 
    private:
+    // Shared by computeQuantized (software int8 MACs) and computeAccelerated
+    // (whole layer on the golden-reference layer engine)
+    void computeQuantizedInternal(const LayerData& dataIn, bool use_hardware) const;
+
+    // Winograd weight transform U = G g G^T of 3x3 layers (no-op for other kernel sizes)
+    void transformWinogradWeights();
+
+    // Quantize and pack the weights of an int4 layer (clears them on an int8 one)
+    void packInt4Weights();
+
     LayerParams weightParam;
     LayerData weightData;
 
     LayerParams biasParam;
     LayerData biasData;
+
+    // Transformed 3x3 weights [16][C][M]: one C x M matrix per point of the 4x4 tile
+    AlignedVector<fp32> winogradWeights;
+
+    // Kept 1 x 16 blocks of the [R*S*C][M] weights of a pruned layer (empty if dense)
+    BlockSparseWeights sparseWeights;
+
+    // int4 weights [R][S][C][M] two per byte, and their scale Sw (see weightScale)
+    AlignedVector<ui8> int4Weights;
+    fp32 int4Scale = 1.0f;
+
+    // See setInputQuantization (unused while fixedSi is 0)
+    fp32 fixedSi = 0.0f;
+    i8 fixedZi = 0;
+    fp32 fixedOutputMax = 0.0f;
 };
 
 // Utility functions for calibrated quantization
 void resetConvLayerCounter();
+void setConvLayerCounter(int count);
 int getCurrentConvLayerCount();
 bool isLayerSpecificCalibrationEnabled();
 void setCalibrationMode(bool use_layer_specific);
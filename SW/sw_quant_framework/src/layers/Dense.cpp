@@ -9,9 +9,12 @@
 #include <sstream>
 #include <map>
 
+#include "../ThreadPool.h"
 #include "../Types.h"
 #include "../Utils.h"
+#include "Int4.h"
 #include "Layer.h"
+#include "Sparse.h"
 
 namespace ML
 {
@@ -40,7 +43,7 @@ namespace ML
     static bool readDenseFileToString(const std::string &path, std::string &content)
     {
 #ifdef ZEDBOARD
-        logInfo("Checking dense calibration path: " + path);
+        ML_LOG_INFO("Checking dense calibration path: " + path);
 
         std::string normalized = path;
         if (normalized.rfind("0:/", 0) != 0)
@@ -183,10 +186,276 @@ namespace ML
         }
 
         dense_calibration_loaded = true;
-        logInfo("Loaded dense calibration stats from " + json_path + " for " + std::to_string(dense_calibration_data.size()) + " layers");
+        ML_LOG_INFO("Loaded dense calibration stats from " + json_path + " for " + std::to_string(dense_calibration_data.size()) + " layers");
         return true;
     }
 
+    // ==========================================================================
+    // OUTPUT-BLOCKED GEMV KERNELS
+    // ==========================================================================
+    // Weights are repacked once at load time (packWeights) into blocks of
+    // DENSE_OUTPUT_BLOCK outputs: [out / block][in][out % block]. For each input
+    // feature the weights of a whole block are contiguous, so the inner loop is a
+    // fixed-width multiply-add over one streaming weight pointer (vectorized by the
+    // compiler) instead of an outputSize-strided walk through the weight matrix.
+    static const size_t DENSE_OUTPUT_BLOCK = 16;
+
+    static size_t denseBlockCount(size_t outputFeatures)
+    {
+        return (outputFeatures + DENSE_OUTPUT_BLOCK - 1) / DENSE_OUTPUT_BLOCK;
+    }
+
+    // fp32: output[o] = bias[o] + sum_i input[i] * W[i][o] for the blocks [firstBlock, lastBlock)
+    static void denseGemvBlocked(const fp32 *ML_RESTRICT input, const fp32 *ML_RESTRICT packed,
+                                 const fp32 *ML_RESTRICT bias, fp32 *ML_RESTRICT output,
+                                 size_t inputFeatures, size_t outputFeatures,
+                                 size_t firstBlock, size_t lastBlock, bool relu)
+    {
+        for (size_t block = firstBlock; block < lastBlock; block++)
+        {
+            const size_t base = block * DENSE_OUTPUT_BLOCK;
+            const size_t count = std::min(DENSE_OUTPUT_BLOCK, outputFeatures - base);
+            const fp32 *w = packed + block * inputFeatures * DENSE_OUTPUT_BLOCK;
+
+            fp32 acc[DENSE_OUTPUT_BLOCK] = {};
+            for (size_t lane = 0; lane < count; lane++)
+                acc[lane] = bias[base + lane];
+
+            for (size_t in_idx = 0; in_idx < inputFeatures; in_idx++)
+            {
+                const fp32 x = input[in_idx];
+                for (size_t lane = 0; lane < DENSE_OUTPUT_BLOCK; lane++)
+                    acc[lane] += x * w[lane];
+                w += DENSE_OUTPUT_BLOCK;
+            }
+
+            for (size_t lane = 0; lane < count; lane++)
+                output[base + lane] = relu ? std::max(0.0f, acc[lane]) : acc[lane];
+        }
+    }
+
+    // acc[lane] += x * Wq[row][lane] over one input row of a packed weight block: int8 blocks
+    // are read in place, int4 blocks (DENSE_OUTPUT_BLOCK / 2 bytes per row, see Int4.h) straight
+    // from their nibbles
+    static inline void denseBlockRowMac(i32 *ML_RESTRICT acc, const i8 *ML_RESTRICT packed, size_t row, i32 x)
+    {
+        const i8 *ML_RESTRICT w = packed + row * DENSE_OUTPUT_BLOCK;
+        for (size_t lane = 0; lane < DENSE_OUTPUT_BLOCK; lane++)
+            acc[lane] += x * static_cast<i32>(w[lane]);
+    }
+
+    static inline void denseBlockRowMac(i32 *ML_RESTRICT acc, const ui8 *ML_RESTRICT packed, size_t row, i32 x)
+    {
+        accumulateInt4(acc, packed, row * DENSE_OUTPUT_BLOCK, x, DENSE_OUTPUT_BLOCK);
+    }
+
+    static inline size_t denseBlockRowBytes(const i8 *) { return DENSE_OUTPUT_BLOCK; }
+    static inline size_t denseBlockRowBytes(const ui8 *) { return DENSE_OUTPUT_BLOCK / 2; }
+
+    // int8 or int4 weights (Packed = i8 or ui8):
+    // accumulators[o] = bias[o] + sum_i input[i] * Wq[i][o] (int32) for the blocks [firstBlock, lastBlock)
+    template <typename Packed>
+    static void denseGemvBlockedInt8(const i8 *ML_RESTRICT input, const Packed *ML_RESTRICT packed,
+                                     const i32 *ML_RESTRICT bias, i32 *ML_RESTRICT accumulators,
+                                     size_t inputFeatures, size_t outputFeatures,
+                                     size_t firstBlock, size_t lastBlock)
+    {
+        for (size_t block = firstBlock; block < lastBlock; block++)
+        {
+            const size_t base = block * DENSE_OUTPUT_BLOCK;
+            const size_t count = std::min(DENSE_OUTPUT_BLOCK, outputFeatures - base);
+            const Packed *blockWeights = packed + block * inputFeatures * denseBlockRowBytes(packed);
+
+            i32 acc[DENSE_OUTPUT_BLOCK] = {};
+            for (size_t lane = 0; lane < count; lane++)
+                acc[lane] = bias[base + lane];
+
+            for (size_t in_idx = 0; in_idx < inputFeatures; in_idx++)
+                denseBlockRowMac(acc, blockWeights, in_idx, input[in_idx]);
+
+            for (size_t lane = 0; lane < count; lane++)
+                accumulators[base + lane] = acc[lane];
+        }
+    }
+
+    // int8 or int4 weights over the nonzero inputs only (one compressed row, see Sparse.h):
+    // accumulators[o] = bias[o] + sum_k values[k] * Wq[index[k]][o]. The values are
+    // centered (ix - zi), so the caller skips the zero-point correction.
+    template <typename Packed>
+    static void denseGemvBlockedInt8Sparse(const SparseRows &rows, const Packed *ML_RESTRICT packed,
+                                           const i32 *ML_RESTRICT bias, i32 *ML_RESTRICT accumulators,
+                                           size_t inputFeatures, size_t outputFeatures,
+                                           size_t firstBlock, size_t lastBlock)
+    {
+        const ui32 nonzero = rows.offsets[1];
+        for (size_t block = firstBlock; block < lastBlock; block++)
+        {
+            const size_t base = block * DENSE_OUTPUT_BLOCK;
+            const size_t count = std::min(DENSE_OUTPUT_BLOCK, outputFeatures - base);
+            const Packed *blockWeights = packed + block * inputFeatures * denseBlockRowBytes(packed);
+
+            i32 acc[DENSE_OUTPUT_BLOCK] = {};
+            for (size_t lane = 0; lane < count; lane++)
+                acc[lane] = bias[base + lane];
+
+            for (ui32 k = 0; k < nonzero; k++)
+                denseBlockRowMac(acc, blockWeights, rows.index[k], rows.values[k]);
+
+            for (size_t lane = 0; lane < count; lane++)
+                accumulators[base + lane] = acc[lane];
+        }
+    }
+
+    // ==========================================================================
+    // BLOCK-SPARSE GEMV KERNELS (pruned layers, see BlockSparse.h)
+    // ==========================================================================
+    // Input row i of the weights holds only its kept 1 x 16 output blocks, so each
+    // input costs one fixed-width multiply-add per kept block and pruned blocks are
+    // never read. Accumulators are padded to whole blocks.
+
+    // acc[blockCol[b] * 16 + j] += x * values[b * 16 + j] over the kept blocks of input row `row`
+    template <typename Acc, typename Weight>
+    static void denseAccumulateBlocks(Acc *ML_RESTRICT acc, const Weight *ML_RESTRICT values,
+                                      const BlockSparseWeights &sparse, Acc x, size_t row)
+    {
+        const ui16 *blockCol = sparse.getBlockCol();
+        for (ui32 b = sparse.getRowStart()[row]; b < sparse.getRowStart()[row + 1]; b++)
+        {
+            Acc *ML_RESTRICT a = acc + blockCol[b] * DENSE_OUTPUT_BLOCK;
+            const Weight *ML_RESTRICT w = values + b * DENSE_OUTPUT_BLOCK;
+            for (size_t lane = 0; lane < DENSE_OUTPUT_BLOCK; lane++)
+                a[lane] += x * static_cast<Acc>(w[lane]);
+        }
+    }
+
+    // Same over packed int4 values (DENSE_OUTPUT_BLOCK / 2 bytes per kept block), read
+    // straight from the nibbles
+    static void denseAccumulateBlocks(i32 *ML_RESTRICT acc, const ui8 *ML_RESTRICT values,
+                                      const BlockSparseWeights &sparse, i32 x, size_t row)
+    {
+        const ui16 *blockCol = sparse.getBlockCol();
+        for (ui32 b = sparse.getRowStart()[row]; b < sparse.getRowStart()[row + 1]; b++)
+            accumulateInt4(acc + blockCol[b] * DENSE_OUTPUT_BLOCK, values, b * DENSE_OUTPUT_BLOCK, x, DENSE_OUTPUT_BLOCK);
+    }
+
+    // int8 or int4 values of the kept blocks (Packed = i8 or ui8): acc[o] += sum_i input[i] * Wq[i][o]
+    // over all inputs, or over the nonzero ones of `rows` (centered, see Sparse.h) if given
+    template <typename Packed>
+    static void denseGemvBlockSparseInt8(const i8 *ML_RESTRICT input, const SparseRows *rows,
+                                         const Packed *ML_RESTRICT values, const BlockSparseWeights &sparse,
+                                         i32 *ML_RESTRICT acc, size_t inputFeatures)
+    {
+        if (rows)
+        {
+            for (ui32 k = 0; k < rows->offsets[1]; k++)
+                denseAccumulateBlocks(acc, values, sparse, static_cast<i32>(rows->values[k]), rows->index[k]);
+        }
+        else
+        {
+            for (size_t in_idx = 0; in_idx < inputFeatures; in_idx++)
+                denseAccumulateBlocks(acc, values, sparse, static_cast<i32>(input[in_idx]), in_idx);
+        }
+    }
+
+    // fp32: output[o] = bias[o] + sum_i input[i] * W[i][o] over the kept blocks; zero inputs are skipped
+    static void denseGemvBlockSparse(const fp32 *ML_RESTRICT input, const BlockSparseWeights &sparse,
+                                     const fp32 *ML_RESTRICT bias, fp32 *ML_RESTRICT acc, fp32 *ML_RESTRICT output,
+                                     size_t inputFeatures, size_t outputFeatures, bool relu)
+    {
+        std::copy(bias, bias + outputFeatures, acc);
+        std::fill(acc + outputFeatures, acc + denseBlockCount(outputFeatures) * DENSE_OUTPUT_BLOCK, 0.0f);
+        for (size_t in_idx = 0; in_idx < inputFeatures; in_idx++)
+        {
+            if (input[in_idx] != 0.0f)
+                denseAccumulateBlocks(acc, sparse.getValues(), sparse, input[in_idx], in_idx);
+        }
+        for (size_t out_idx = 0; out_idx < outputFeatures; out_idx++)
+            output[out_idx] = relu ? std::max(0.0f, acc[out_idx]) : acc[out_idx];
+    }
+
+    // Build the output-blocked fp32 and int8 (or packed int4) weight copies. The quantized
+    // weights use the symmetric per-layer scale Sw = 127 / max|w| (clipped for int4, see weightScale).
+    void DenseLayer::packWeights()
+    {
+        const size_t inputFeatures = weightParam.dims[0];
+        const size_t outputFeatures = weightParam.dims[1];
+        const size_t packedSize = denseBlockCount(outputFeatures) * inputFeatures * DENSE_OUTPUT_BLOCK;
+        const fp32 *weights = static_cast<const fp32 *>(weightData.raw());
+
+        qWeightScale = weightScale(weights, inputFeatures * outputFeatures, weightBits);
+
+        packedWeights.assign(packedSize, 0.0f);
+        AlignedVector<i8> quantized(packedSize, 0);
+        qWeightSums.assign(outputFeatures, 0);
+
+        for (size_t in_idx = 0; in_idx < inputFeatures; in_idx++)
+        {
+            for (size_t out_idx = 0; out_idx < outputFeatures; out_idx++)
+            {
+                const fp32 w = weights[in_idx * outputFeatures + out_idx];
+                const size_t dst = ((out_idx / DENSE_OUTPUT_BLOCK) * inputFeatures + in_idx) * DENSE_OUTPUT_BLOCK +
+                                   out_idx % DENSE_OUTPUT_BLOCK;
+                const i8 q = quantizeWeight(w, qWeightScale, weightBits);
+
+                packedWeights[dst] = w;
+                quantized[dst] = q;
+                qWeightSums[out_idx] += q;
+            }
+        }
+
+        // Keep only the copy the quantized kernels read: int4 halves it
+        if (weightBits == 4)
+        {
+            packedQ4Weights.resize(int4Bytes(packedSize));
+            packInt4(quantized.data(), packedSize, packedQ4Weights.data());
+            packedQWeights.clear();
+        }
+        else
+        {
+            packedQWeights.swap(quantized);
+            packedQ4Weights.clear();
+        }
+
+        // Quantized copy of the kept blocks of a pruned layer (padding lanes stay zero), packed
+        // two per byte at int4
+        const size_t sparseSize = sparseWeights.blockCount() * DENSE_OUTPUT_BLOCK;
+        AlignedVector<i8> sparseQuantized(sparseSize);
+        for (size_t i = 0; i < sparseSize; i++)
+        {
+            sparseQuantized[i] = quantizeWeight(sparseWeights.getValues()[i], qWeightScale, weightBits);
+        }
+        if (weightBits == 4)
+        {
+            sparseQ4Values.resize(int4Bytes(sparseSize));
+            packInt4(sparseQuantized.data(), sparseSize, sparseQ4Values.data());
+            sparseQValues.clear();
+        }
+        else
+        {
+            sparseQValues.swap(sparseQuantized);
+            sparseQ4Values.clear();
+        }
+
+        ML_LOG_DEBUG("Packed dense weights (" + std::to_string(inputFeatures) + " x " + std::to_string(outputFeatures) +
+                     ") into " + std::to_string(denseBlockCount(outputFeatures)) + " output blocks, int" +
+                     std::to_string(weightBits));
+    }
+
+    void DenseLayer::setWeightBits(unsigned bits)
+    {
+        Layer::setWeightBits(bits);
+        weightBits = bits;
+        if (weightData.isAlloced())
+        {
+            packWeights();
+        }
+    }
+
+    double DenseLayer::weightQuantizationError(unsigned bits) const
+    {
+        return ML::weightQuantizationError(static_cast<const fp32 *>(weightData.raw()), weightParam.flat_count(), bits);
+    }
+
     void DenseLayer::computeNaive(const LayerData &dataIn) const
     {
         // const auto &inputDims = getInputParams().dims;   // Can be [H, W, C] or [features]
@@ -215,22 +484,23 @@ namespace ML
             return;
         }
 
-        const LayerData &weights = getWeightData();
-        LayerData &output = getOutputData();
-        const LayerData &bias = getBiasData();
+        const TensorView<const fp32> input = dataIn.view<fp32>();
+        const TensorView<const fp32> weights = getWeightData().view<fp32>();
+        const TensorView<const fp32> bias = getBiasData().view<fp32>();
+        const TensorView<fp32> output = getOutputData().view<fp32>();
 
         // Dense layer computation: output = input * weights + bias
         // Input is treated as flattened regardless of original dimensions
         for (size_t out_idx = 0; out_idx < outputSize; out_idx++)
         {
-            fp32 sum = bias.get<fp32>(out_idx);
+            fp32 sum = bias[out_idx];
 
             for (size_t in_idx = 0; in_idx < totalInputFeatures; in_idx++)
             {
                 // Weight matrix: [input_features, output_features]
                 size_t weightIdx = in_idx * outputSize + out_idx;
 
-                sum += dataIn.get<fp32>(in_idx) * weights.get<fp32>(weightIdx);
+                sum += input[in_idx] * weights[weightIdx];
             }
             // Apply ReLU activation only for hidden layers (not the final layer before Softmax)
             // The final dense layer typically has 200 outputs (for classification)
@@ -243,29 +513,78 @@ namespace ML
             // For the final layer (outputSize == 200), don't apply ReLU
 
             // Store result in output
-            output.get<fp32>(out_idx) = sum;
+            output[out_idx] = sum;
         }
     }
 
     void DenseLayer::computeThreaded(const LayerData &dataIn) const
     {
-        // For simplicity, use naive implementation with thread hints
-        // TODO: Implement actual threading
-        computeNaive(dataIn);
+        size_t totalInputFeatures = getInputParams().flat_count();
+        size_t outputSize = getOutputParams().flat_count();
+
+        if (totalInputFeatures != getWeightParams().dims[0] || outputSize != getWeightParams().dims[1])
+        {
+            std::cerr << "Dense layer size mismatch: got " << totalInputFeatures << " -> " << outputSize
+                      << ", weights are " << getWeightParams().dims[0] << " x " << getWeightParams().dims[1] << std::endl;
+            return;
+        }
+
+        const fp32 *input = static_cast<const fp32 *>(dataIn.raw());
+        const fp32 *bias = static_cast<const fp32 *>(getBiasData().raw());
+        fp32 *output = static_cast<fp32 *>(getOutputData().raw());
+        const bool relu = outputSize != 200;
+
+        // Each worker owns a contiguous run of output blocks, i.e. a contiguous slice of the
+        // packed weights and whole cache lines of the output. Small layers stay on one thread.
+        const size_t macsPerBlock = totalInputFeatures * DENSE_OUTPUT_BLOCK;
+        const size_t minBlocks = ThreadPool::minChunk(macsPerBlock);
+
+        ThreadPool::shared().parallelFor(denseBlockCount(outputSize), minBlocks, [&](size_t first, size_t last) {
+            denseGemvBlocked(input, packedWeights.data(), bias, output, totalInputFeatures, outputSize, first, last, relu);
+        });
     }
 
     void DenseLayer::computeTiled(const LayerData &dataIn) const
     {
-        // For simplicity, use naive implementation
-        // TODO: Implement tiled matrix multiplication
-        computeNaive(dataIn);
+        // The output-blocked GEMV is the tiled dense layer
+        computeSIMD(dataIn);
     }
 
     void DenseLayer::computeSIMD(const LayerData &dataIn) const
     {
-        // For simplicity, use naive implementation
-        // TODO: Implement SIMD optimized matrix multiplication
-        computeNaive(dataIn);
+        size_t totalInputFeatures = getInputParams().flat_count();
+        size_t outputSize = getOutputParams().flat_count();
+
+        if (totalInputFeatures != getWeightParams().dims[0] || outputSize != getWeightParams().dims[1])
+        {
+            std::cerr << "Dense layer size mismatch: got " << totalInputFeatures << " -> " << outputSize
+                      << ", weights are " << getWeightParams().dims[0] << " x " << getWeightParams().dims[1] << std::endl;
+            return;
+        }
+
+        // ReLU on hidden layers only (the 200-output classifier feeds Softmax)
+        if (usesBlockSparse())
+        {
+            fp32 *acc = scratch().alloc<fp32>(denseBlockCount(outputSize) * DENSE_OUTPUT_BLOCK).data();
+            denseGemvBlockSparse(static_cast<const fp32 *>(dataIn.raw()), sparseWeights,
+                                 static_cast<const fp32 *>(getBiasData().raw()), acc,
+                                 static_cast<fp32 *>(getOutputData().raw()), totalInputFeatures, outputSize,
+                                 outputSize != 200);
+            return;
+        }
+        denseGemvBlocked(static_cast<const fp32 *>(dataIn.raw()), packedWeights.data(),
+                         static_cast<const fp32 *>(getBiasData().raw()), static_cast<fp32 *>(getOutputData().raw()),
+                         totalInputFeatures, outputSize, 0, denseBlockCount(outputSize), outputSize != 200);
+    }
+
+    size_t DenseLayer::getWorkspaceSize() const
+    {
+        const size_t outputSize = getOutputParams().flat_count();
+        const size_t inputSize = getInputParams().flat_count();
+        const size_t paddedOutput = denseBlockCount(outputSize) * DENSE_OUTPUT_BLOCK;
+        return std::max(Workspace::bytesFor<i8>(inputSize) + Workspace::bytesFor<i32>(outputSize) +
+                            Workspace::bytesFor<i32>(paddedOutput) + sparseRowsBytes(1, inputSize),
+                        Workspace::bytesFor<fp32>(paddedOutput));
     }
 
     void DenseLayer::computeQuantized(const LayerData &dataIn) const
@@ -289,7 +608,7 @@ namespace ML
             bool found = false;
             for (const auto &path : possible_paths)
             {
-                logInfo("Attempting to load dense calibration file: " + path);
+                ML_LOG_INFO("Attempting to load dense calibration file: " + path);
                 if (loadDenseCalibrationStats(path))
                 {
                     found = true;
@@ -300,7 +619,7 @@ namespace ML
             if (!found)
             {
                 logError("Could not find calibration_stats.json file for dense layers");
-                logInfo("Falling back to runtime quantization parameter calculation");
+                ML_LOG_INFO("Falling back to runtime quantization parameter calculation");
                 // Fall back to the original implementation would go here
                 return;
             }
@@ -311,6 +630,12 @@ namespace ML
         // ==========================================================================
         size_t totalInputFeatures = getInputParams().flat_count();
         size_t outputSize = getOutputParams().flat_count();
+        const TensorView<const fp32> input = dataIn.view<fp32>();
+        const TensorView<const fp32> bias = getBiasData().view<fp32>();
+        const TensorView<fp32> output = getOutputData().view<fp32>();
+
+        // Quantized operands live in the model's scratch arena (no per-call heap allocations)
+        Workspace &workspace = scratch();
 
         // ==========================================================================
         // ADAPTIVE CALIBRATION SELECTION FOR DENSE LAYERS
@@ -331,12 +656,12 @@ namespace ML
         if (use_dense_layer_specific_calibration || outputSize == 200)
         {
             // FULL INFERENCE MODE OR FINAL DENSE LAYER: Calculate adaptive input statistics from actual data
-            fp32 input_min = dataIn.get<fp32>(0);
-            fp32 input_max = dataIn.get<fp32>(0);
+            fp32 input_min = input[0];
+            fp32 input_max = input[0];
 
             for (size_t i = 0; i < totalInputFeatures; i++)
             {
-                fp32 val = dataIn.get<fp32>(i);
+                fp32 val = input[i];
                 if (val < input_min)
                     input_min = val;
                 if (val > input_max)
@@ -360,9 +685,9 @@ namespace ML
             calibration_mode = "ADAPTIVE";
             dense_layer_count++;
 
-            logInfo("\n\nADAPTIVE: Using runtime-calculated Si=" + std::to_string(Si) +
-                    ", zi=" + std::to_string(static_cast<int>(zi)) +
-                    " (input range: " + std::to_string(input_min) + " to " + std::to_string(input_max) + ")");
+            ML_LOG_INFO("\n\nADAPTIVE: Using runtime-calculated Si=" + std::to_string(Si) +
+                        ", zi=" + std::to_string(static_cast<int>(zi)) +
+                        " (input range: " + std::to_string(input_min) + " to " + std::to_string(input_max) + ")");
         }
         else
         {
@@ -384,8 +709,8 @@ namespace ML
             zi = input_stats.zi;
             calibration_mode = "_input";
 
-            logInfo("Using calibration stats: _input - Si=" + std::to_string(Si) +
-                    ", zi=" + std::to_string(static_cast<int>(zi)));
+            ML_LOG_INFO("Using calibration stats: _input - Si=" + std::to_string(Si) +
+                        ", zi=" + std::to_string(static_cast<int>(zi)));
         }
 
         // Identify current layer for logging purposes
@@ -407,133 +732,126 @@ namespace ML
             current_layer_name = "unknown_dense"; // Unknown configuration
         }
 
-        logInfo("Processing dense layer: " + current_layer_name + " (input_features: " +
-                std::to_string(totalInputFeatures) + ", output_features: " + std::to_string(outputSize) +
-                ") using " + calibration_mode + " calibration");
+        ML_LOG_INFO("Processing dense layer: " + current_layer_name + " (input_features: " +
+                    std::to_string(totalInputFeatures) + ", output_features: " + std::to_string(outputSize) +
+                    ") using " + calibration_mode + " calibration");
 
         // ==========================================================================
         // SECTION 3: USE PRE-CALCULATED QUANTIZATION PARAMETERS
         // ==========================================================================
 
         // -------------------------
-        // 3.1: Calculate WEIGHT SCALE (Sw) - Still calculated at runtime
+        // 3.1: WEIGHT SCALE (Sw) - computed with the int8 weights at load time (packWeights)
         // -------------------------
-        size_t weight_size = totalInputFeatures * outputSize;
-        fp32 max_weight = 0.0f;
-
-        for (size_t i = 0; i < weight_size; i++)
-        {
-            fp32 abs_val = std::abs(getWeightData().get<fp32>(i));
-            if (abs_val > max_weight)
-            {
-                max_weight = abs_val;
-            }
-        }
-
-        if (max_weight < 1e-8f)
-        {
-            max_weight = 1.0f;
-        }
-
-        fp32 Sw = 127.0f / max_weight;
-        logDebug("Dense weight scale Sw = " + std::to_string(Sw) + " (max_weight = " + std::to_string(max_weight) + ")");
+        fp32 Sw = qWeightScale;
+        ML_LOG_DEBUG("Dense weight scale Sw = " + std::to_string(Sw));
 
         // -------------------------
         // 3.2: Use CALCULATED INPUT SCALE (Si) and ZERO POINT (zi)
         // -------------------------
         // These come from either adaptive calculation or "_input" calibration
-        logDebug("Using dense input scale Si = " + std::to_string(Si) +
-                 ", zero point zi = " + std::to_string(static_cast<int>(zi)));
+        ML_LOG_DEBUG("Using dense input scale Si = " + std::to_string(Si) +
+                     ", zero point zi = " + std::to_string(static_cast<int>(zi)));
 
         // -------------------------
         // 3.3: Calculate BIAS SCALE (Sb)
         // -------------------------
         fp32 Sb = Si * Sw;
-        logDebug("Dense bias scale Sb = " + std::to_string(Sb));
+        ML_LOG_DEBUG("Dense bias scale Sb = " + std::to_string(Sb));
 
         // ==========================================================================
         // SECTION 4: QUANTIZE ALL INPUTS (BEFORE COMPUTATION LOOPS)
         // ==========================================================================
-        std::vector<i8> quantized_input(totalInputFeatures);
+        TensorView<i8> quantized_input = workspace.alloc<i8>(totalInputFeatures);
 
         for (size_t i = 0; i < totalInputFeatures; i++)
         {
-            i32 temp = static_cast<i32>(std::round(Si * dataIn.get<fp32>(i))) + zi;
+            i32 temp = static_cast<i32>(std::round(Si * input[i])) + zi;
             quantized_input[i] =
                 static_cast<i8>(std::max<i32>(-128, std::min<i32>(127, temp)));
         }
 
-        logDebug("Quantized " + std::to_string(totalInputFeatures) + " dense input values to int8");
+        ML_LOG_DEBUG("Quantized " + std::to_string(totalInputFeatures) + " dense input values to int8");
 
         // ==========================================================================
-        // SECTION 5: QUANTIZE ALL WEIGHTS (BEFORE COMPUTATION LOOPS)
+        // SECTION 5: WEIGHTS - quantized to int8 and packed into output blocks at load time
         // ==========================================================================
-        std::vector<i8> quantized_weights(weight_size);
-
-        for (size_t i = 0; i < weight_size; i++)
-        {
-            i32 temp = static_cast<i32>(std::round(Sw * getWeightData().get<fp32>(i)));
-            quantized_weights[i] =
-                static_cast<i8>(std::max<i32>(-128, std::min<i32>(127, temp)));
-        }
-
-        logDebug("Quantized " + std::to_string(weight_size) + " dense weight values to int8");
 
         // ==========================================================================
         // SECTION 6: QUANTIZE ALL BIASES (BEFORE COMPUTATION LOOPS)
         // ==========================================================================
-        std::vector<i32> quantized_biases(outputSize);
+        TensorView<i32> quantized_biases = workspace.alloc<i32>(outputSize);
 
         for (size_t out_idx = 0; out_idx < outputSize; out_idx++)
         {
-            quantized_biases[out_idx] = static_cast<i32>(std::round(Sb * getBiasData().get<fp32>(out_idx)));
+            quantized_biases[out_idx] = static_cast<i32>(std::round(Sb * bias[out_idx]));
         }
 
-        logDebug("Quantized " + std::to_string(outputSize) + " dense bias values to int32");
+        ML_LOG_DEBUG("Quantized " + std::to_string(outputSize) + " dense bias values to int32");
 
         // ==========================================================================
         // SECTION 7: MAIN DENSE COMPUTATION LOOP
         // ==========================================================================
-        logDebug("Starting dense computation loops...");
+        ML_LOG_DEBUG("Starting dense computation loops...");
+
+        // Dense layer computation: accumulator = quantized bias + input * weights (int32).
+        // Sparse inputs (mostly ReLU zeros, i.e. zi) only multiply their nonzero entries.
+        const size_t nonzero = countNonzero(quantized_input.data(), totalInputFeatures, zi);
+        const fp32 density = static_cast<fp32>(nonzero) / totalInputFeatures;
+        const bool sparse = density < sparseDensityThreshold && totalInputFeatures <= 65536;
+        ML_LOG_INFO("Dense layer " + current_layer_name + " input density " + std::to_string(100.0f * density) + "%, " +
+                    (sparse ? "sparse" : "dense") + " MACs");
+
+        // Padded to whole blocks for the block-sparse kernel of a pruned layer
+        TensorView<i32> accumulators = workspace.alloc<i32>(denseBlockCount(outputSize) * DENSE_OUTPUT_BLOCK);
+        if (usesBlockSparse())
+        {
+            // Kept weight blocks only; composes with the activation sparsity above
+            i32 *acc = accumulators.data();
+            std::copy(quantized_biases.data(), quantized_biases.data() + outputSize, acc);
+            std::fill(acc + outputSize, acc + accumulators.size(), 0);
+            SparseRows rows = {};
+            if (sparse)
+                rows = compressRows(quantized_input.data(), 1, totalInputFeatures, nonzero, zi, workspace);
+            if (weightBits == 4)
+                denseGemvBlockSparseInt8(quantized_input.data(), sparse ? &rows : nullptr, sparseQ4Values.data(),
+                                         sparseWeights, acc, totalInputFeatures);
+            else
+                denseGemvBlockSparseInt8(quantized_input.data(), sparse ? &rows : nullptr, sparseQValues.data(),
+                                         sparseWeights, acc, totalInputFeatures);
+        }
+        else if (sparse)
+        {
+            const SparseRows rows = compressRows(quantized_input.data(), 1, totalInputFeatures, nonzero, zi, workspace);
+            if (weightBits == 4)
+                denseGemvBlockedInt8Sparse(rows, packedQ4Weights.data(), quantized_biases.data(), accumulators.data(),
+                                           totalInputFeatures, outputSize, 0, denseBlockCount(outputSize));
+            else
+                denseGemvBlockedInt8Sparse(rows, packedQWeights.data(), quantized_biases.data(), accumulators.data(),
+                                           totalInputFeatures, outputSize, 0, denseBlockCount(outputSize));
+        }
+        else
+        {
+            if (weightBits == 4)
+                denseGemvBlockedInt8(quantized_input.data(), packedQ4Weights.data(), quantized_biases.data(),
+                                     accumulators.data(), totalInputFeatures, outputSize, 0, denseBlockCount(outputSize));
+            else
+                denseGemvBlockedInt8(quantized_input.data(), packedQWeights.data(), quantized_biases.data(),
+                                     accumulators.data(), totalInputFeatures, outputSize, 0, denseBlockCount(outputSize));
+        }
 
-        // Dense layer computation: output = input * weights + bias
         for (size_t out_idx = 0; out_idx < outputSize; out_idx++)
         {
-            // Initialize accumulator with QUANTIZED bias
-            i32 accumulator = quantized_biases[out_idx];
-
-            // Perform quantized matrix multiplication
-            for (size_t in_idx = 0; in_idx < totalInputFeatures; in_idx++)
-            {
-                // Weight matrix: [input_features, output_features]
-                size_t weight_idx = in_idx * outputSize + out_idx;
-
-                // Get pre-quantized values (already int8)
-                i8 input_val = quantized_input[in_idx];
-                i8 weight_val = quantized_weights[weight_idx];
-
-                // int8 multiply-accumulate operation
-                accumulator += static_cast<i32>(input_val) * static_cast<i32>(weight_val);
-            }
-
             // ==========================================================
             // SECTION 8: DEQUANTIZE BACK TO FP32 WITH ZERO-POINT CORRECTION
             // ==========================================================
-            // MATHEMATICAL FIX: Correct zero-point offset calculation
             // Standard asymmetric quantization formula:
             // result = (accumulator - zi * Σ(weights)) / (Si * Sw)
+            // Σ(weights) per output neuron is precomputed at load time.
+            // The sparse kernel accumulated (ix - zi) and needs no correction.
             // ==========================================================
-
-            // Calculate sum of quantized weights for this output neuron
-            i32 weight_sum = 0;
-            for (size_t in_idx = 0; in_idx < totalInputFeatures; in_idx++)
-            {
-                size_t weight_idx = in_idx * outputSize + out_idx;
-                weight_sum += static_cast<i32>(quantized_weights[weight_idx]);
-            }
-
-            // Apply zero-point correction: subtract the accumulated zero-point bias
-            i32 corrected_accumulator = accumulator - (static_cast<i32>(zi) * weight_sum);
+            i32 corrected_accumulator =
+                sparse ? accumulators[out_idx] : accumulators[out_idx] - (static_cast<i32>(zi) * qWeightSums[out_idx]);
 
             // Dequantize to floating point
             fp32 result = static_cast<fp32>(corrected_accumulator) / (Si * Sw);
@@ -549,36 +867,40 @@ namespace ML
             // For final layer (200 outputs), no ReLU before softmax
 
             // Store result in output array
-            getOutputData().get<fp32>(out_idx) = result;
+            output[out_idx] = result;
         }
 
+        ML_LOG_INFO("Dense layer " + current_layer_name + " quantized computation complete");
+
         // ==========================================================================
         // DEBUG OUTPUT: Verify calibrated quantization worked correctly
         // ==========================================================================
-        fp32 output_min = getOutputData().get<fp32>(0);
-        fp32 output_max = getOutputData().get<fp32>(0);
-        fp32 output_avg = 0.0f;
-        size_t zero_count = 0;
-
-        for (size_t i = 0; i < outputSize; i++)
-        {
-            fp32 val = getOutputData().get<fp32>(i);
-            output_avg += val;
-            if (val < output_min)
-                output_min = val;
-            if (val > output_max)
-                output_max = val;
-            if (val == 0.0f)
-                zero_count++;
-        }
-        output_avg /= outputSize;
-
-        logInfo("Dense layer " + current_layer_name + " quantized computation complete");
-        logDebug("Output statistics - Min: " + std::to_string(output_min) +
-                 ", Max: " + std::to_string(output_max) +
-                 ", Avg: " + std::to_string(output_avg));
-        logDebug("Zero outputs: " + std::to_string(zero_count) + "/" + std::to_string(outputSize) +
-                 " (" + std::to_string(100.0f * zero_count / outputSize) + "%)");
+        // (a full pass over the output, so only when debug logging is on)
+        if (logEnabled(LogLevel::Debug))
+        {            fp32 output_min = output[0];
+            fp32 output_max = output[0];
+            fp32 output_avg = 0.0f;
+            size_t zero_count = 0;
+
+            for (size_t i = 0; i < outputSize; i++)
+            {
+                fp32 val = output[i];
+                output_avg += val;
+                if (val < output_min)
+                    output_min = val;
+                if (val > output_max)
+                    output_max = val;
+                if (val == 0.0f)
+                    zero_count++;
+            }
+            output_avg /= outputSize;
+
+            logDebug("Output statistics - Min: " + std::to_string(output_min) +
+                     ", Max: " + std::to_string(output_max) +
+                     ", Avg: " + std::to_string(output_avg));
+            logDebug("Zero outputs: " + std::to_string(zero_count) + "/" + std::to_string(outputSize) +
+                     " (" + std::to_string(100.0f * zero_count / outputSize) + "%)");
+        }
     }
 
     // ==========================================================================
@@ -616,14 +938,14 @@ namespace ML
     void resetDenseLayerCounter()
     {
         dense_layer_count = 0;
-        logInfo("Reset dense calibration state: dense_layer_count = 0");
+        ML_LOG_INFO("Reset dense calibration state: dense_layer_count = 0");
     }
     // Enable layer-specific calibration for dense layers
     void setDenseCalibrationMode(bool use_layer_specific)
     {
         use_dense_layer_specific_calibration = use_layer_specific;
         resetDenseLayerCounter();
-        logInfo("Set dense calibration mode: " + std::string(use_layer_specific ? "layer-specific" : "individual-tests"));
+        ML_LOG_INFO("Set dense calibration mode: " + std::string(use_layer_specific ? "layer-specific" : "individual-tests"));
     }
 
     // Get current dense layer counter value (for debugging)
@@ -638,11 +960,11 @@ namespace ML
         use_dense_layer_specific_calibration = enable;
         if (enable)
         {
-            logInfo("Enabled dense layer-specific calibration for full inference chains");
+            ML_LOG_INFO("Enabled dense layer-specific calibration for full inference chains");
         }
         else
         {
-            logInfo("Using raw input calibration for all dense layers (individual layer test mode)");
+            ML_LOG_INFO("Using raw input calibration for all dense layers (individual layer test mode)");
         }
     }
 
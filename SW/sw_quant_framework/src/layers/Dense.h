@@ -1,7 +1,10 @@
 #pragma once
 
+#include <vector>
+
 #include "../Types.h"
 #include "../Utils.h"
+#include "BlockSparse.h"
 #include "Layer.h"
 
 namespace ML {
@@ -23,8 +26,9 @@ class DenseLayer : public Layer {
     // Allocate all resources needed for the layer & Load all of the required data for the layer
     virtual void allocLayer() override {
         Layer::allocLayer();
-        weightData.loadData();
+        sparseWeights = loadLayerWeights(weightData, weightParam.dims[0], weightParam.dims[1]);  // .bsr if pruned
         biasData.loadData();
+        packWeights();
     }
 
     // Free all resources allocated for the layer
@@ -32,6 +36,13 @@ class DenseLayer : public Layer {
         Layer::freeLayer();
         weightData.freeData();
         biasData.freeData();
+        packedWeights.clear();
+        packedQWeights.clear();
+        packedQ4Weights.clear();
+        qWeightSums.clear();
+        sparseWeights = BlockSparseWeights();
+        sparseQValues.clear();
+        sparseQ4Values.clear();
     }
 
     // Virtual functions
@@ -41,12 +52,49 @@ class DenseLayer : public Layer {
     virtual void computeSIMD(const LayerData& dataIn) const override;
     virtual void computeQuantized(const LayerData& dataIn) const override;
 
+    // int8 input, int32 biases and accumulators of computeQuantized, plus the sparse input list
+    // (or the padded fp32 accumulators of the block-sparse computeSIMD)
+    virtual std::size_t getWorkspaceSize() const override;
+
+    // One MAC per weight (per kept weight of a block-sparse layer)
+    virtual std::size_t getMacs() const override {
+        const std::size_t macs = weightParam.flat_count();
+        return usesBlockSparse() ? static_cast<std::size_t>(macs * sparseWeights.density()) : macs;
+    }
+    virtual std::size_t getWeightBytes() const override {
+        return (usesBlockSparse() ? sparseWeights.fileBytes() : weightParam.byte_size()) + biasParam.byte_size();
+    }
+
+    // computeSIMD and computeQuantized iterate only the kept weight blocks of a pruned layer
+    bool usesBlockSparse() const { return !sparseWeights.empty(); }
+
+    // int4 weights are packed two per byte in place of the int8 copy (repacked if allocated)
+    virtual void setWeightBits(unsigned bits) override;
+    virtual double weightQuantizationError(unsigned bits) const override;
+
    private:
+    // Repack the [input_features, output_features] weights into output blocks
+    // (fp32, and int8 or int4) so the GEMV kernels stream them contiguously
+    void packWeights();
+
     LayerParams weightParam;
     LayerData weightData;
 
     LayerParams biasParam;
     LayerData biasData;
+
+    // Output-blocked weights [out / block][in][out % block], last block zero padded
+    AlignedVector<fp32> packedWeights;
+    AlignedVector<i8> packedQWeights;    // int8 layers
+    AlignedVector<ui8> packedQ4Weights;  // int4 layers, two per byte (DENSE_OUTPUT_BLOCK / 2 bytes per row)
+    AlignedVector<i32> qWeightSums;      // Sum of quantized weights per output (zero-point correction)
+    fp32 qWeightScale = 1.0f;            // Sw = 127 / max|w| (clipped for int4, see weightScale)
+
+    // Kept 1 x 16 blocks of the [in][out] weights of a pruned layer (empty if dense),
+    // and their quantized values (int8, or int4 two per byte)
+    BlockSparseWeights sparseWeights;
+    AlignedVector<i8> sparseQValues;
+    AlignedVector<ui8> sparseQ4Values;
 };
 
 // Utility functions for calibrated quantization - Dense layers
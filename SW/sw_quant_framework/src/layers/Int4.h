@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "../Types.h"
+
+namespace ML {
+
+// int4 weights of the quantized paths (Layer::setWeightBits(4)).
+// Weights are quantized symmetrically like the int8 ones, wx = round(Sw * Wx), and stored
+// two per byte: element 2k in the low nibble of byte k, element 2k + 1 in the high nibble
+// (two's complement). Kernels multiply them straight from the nibbles (accumulateInt4), so
+// no int8 copy is kept, and the int32 accumulation and dequantization are unchanged.
+
+// Largest magnitude of a symmetric weight of 4 or 8 bits
+inline i32 weightQuantMax(unsigned bits) { return bits == 4 ? 7 : 127; }
+
+// Bytes of `count` packed int4 values
+inline std::size_t int4Bytes(std::size_t count) { return (count + 1) / 2; }
+
+// Symmetric quantization of one weight to `bits` (scale = weightQuantMax(bits) / max|w|)
+inline i8 quantizeWeight(fp32 w, fp32 scale, unsigned bits) {
+    const i32 limit = weightQuantMax(bits);
+    return static_cast<i8>(std::max<i32>(-limit, std::min<i32>(limit, static_cast<i32>(std::round(scale * w)))));
+}
+
+// Sign-extended low and high nibble of a byte
+inline i8 lowInt4(ui8 byte) { return static_cast<i8>(static_cast<i8>(static_cast<ui8>(byte << 4)) >> 4); }
+inline i8 highInt4(ui8 byte) { return static_cast<i8>(static_cast<i8>(byte) >> 4); }
+
+// Scalar access to element i
+inline i8 int4At(const ui8* packed, std::size_t i) {
+    return (i & 1) ? highInt4(packed[i / 2]) : lowInt4(packed[i / 2]);
+}
+
+// Pack `count` values in [-8, 7]; an odd tail leaves the last high nibble zero
+inline void packInt4(const i8* values, std::size_t count, ui8* packed) {
+    for (std::size_t k = 0; k < count / 2; k++) {
+        packed[k] = static_cast<ui8>((values[2 * k] & 0x0F) | ((values[2 * k + 1] & 0x0F) << 4));
+    }
+    if (count & 1) packed[count / 2] = static_cast<ui8>(values[count - 1] & 0x0F);
+}
+
+// Unpack `count` values to int8 (for consumers of int8 weights, e.g. the layer engine)
+inline void unpackInt4(const ui8* ML_RESTRICT packed, std::size_t count, i8* ML_RESTRICT values) {
+    for (std::size_t k = 0; k < count / 2; k++) {
+        values[2 * k] = lowInt4(packed[k]);
+        values[2 * k + 1] = highInt4(packed[k]);
+    }
+    if (count & 1) values[count - 1] = int4At(packed, count - 1);
+}
+
+// acc[i] += x * w[first + i] for `count` packed values: both nibbles of each byte are sign
+// extended with shifts and multiplied in place (an odd `first` or tail is handled alone)
+inline void accumulateInt4(i32* ML_RESTRICT acc, const ui8* ML_RESTRICT packed, std::size_t first, i32 x,
+                           std::size_t count) {
+    if (count && (first & 1)) {
+        *acc++ += x * int4At(packed, first++);
+        count--;
+    }
+    packed += first / 2;
+    for (std::size_t k = 0; k < count / 2; k++) {
+        acc[2 * k] += x * lowInt4(packed[k]);
+        acc[2 * k + 1] += x * highInt4(packed[k]);
+    }
+    if (count & 1) acc[count - 1] += x * int4At(packed, count - 1);
+}
+
+// Largest |w|, or 1 for an all-zero tensor (the scale stays finite)
+inline fp32 maxAbsWeight(const fp32* weights, std::size_t count) {
+    fp32 maxWeight = 0.0f;
+    for (std::size_t i = 0; i < count; i++) {
+        maxWeight = std::max(maxWeight, std::abs(weights[i]));
+    }
+    return maxWeight < 1e-8f ? 1.0f : maxWeight;
+}
+
+// Squared error sum_i (w - wx / Sw)^2 of quantizing the weights with one scale
+inline double weightSquaredError(const fp32* weights, std::size_t count, fp32 scale, unsigned bits) {
+    double error = 0.0;
+    for (std::size_t i = 0; i < count; i++) {
+        const double diff = weights[i] - quantizeWeight(weights[i], scale, bits) / static_cast<double>(scale);
+        error += diff * diff;
+    }
+    return error;
+}
+
+// Weight scale Sw of a layer. int8: 127 / max|w|. int4: the 15 levels are too coarse to
+// span the rare largest weights, so the range is clipped to the fraction of max|w| (1 down
+// to 0.3) with the least squared error; on the toy model this halves the error of 7 / max|w|.
+inline fp32 weightScale(const fp32* weights, std::size_t count, unsigned bits) {
+    const fp32 maxWeight = maxAbsWeight(weights, count);
+    fp32 best = weightQuantMax(bits) / maxWeight;
+    if (bits != 4) return best;
+
+    double bestError = weightSquaredError(weights, count, best, bits);
+    for (int tenths = 9; tenths >= 3; tenths--) {
+        const fp32 scale = weightQuantMax(bits) / (maxWeight * tenths / 10.0f);
+        const double error = weightSquaredError(weights, count, scale, bits);
+        if (error < bestError) {
+            best = scale;
+            bestError = error;
+        }
+    }
+    return best;
+}
+
+// Relative RMS error ||w - wx / Sw|| / ||w|| of quantizing the weights to `bits`
+inline double weightQuantizationError(const fp32* weights, std::size_t count, unsigned bits) {
+    double norm = 0.0;
+    for (std::size_t i = 0; i < count; i++) {
+        norm += static_cast<double>(weights[i]) * weights[i];
+    }
+    const double error = weightSquaredError(weights, count, weightScale(weights, count, bits), bits);
+    return norm > 0.0 ? std::sqrt(error / norm) : 0.0;
+}
+
+}  // namespace ML
@@ -1,9 +1,12 @@
 #include "Layer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
+#include "../ThreadPool.h"
 #include "../Utils.h"
 
 namespace ML {
@@ -22,4 +25,173 @@ bool LayerParams::isCompatible(const LayerParams& params) const {
 // Ensure that data being inputted is of the correct size and shape that the layer expects
 bool Layer::checkDataInputCompatibility(const LayerData& data) const { return inParams.isCompatible(data.getParams()); }
 
+// Dispatch to the compute function of an inference type
+void Layer::compute(const LayerData& dataIn, InfType infType) const {
+    switch (infType) {
+    case InfType::NAIVE:
+        computeNaive(dataIn);
+        break;
+    case InfType::THREADED:
+        computeThreaded(dataIn);
+        break;
+    case InfType::TILED:
+        computeTiled(dataIn);
+        break;
+    case InfType::SIMD:
+        computeSIMD(dataIn);
+        break;
+    case InfType::QUANTIZED:
+        computeQuantized(dataIn);
+        break;
+    case InfType::ACCELERATED:
+        computeAccelerated(dataIn);
+        break;
+    case InfType::AUTO:
+        compute(dataIn, tunedType);
+        break;
+    default:
+        assert(false && "Inference Type not implemented");
+    }
+}
+
+void Layer::setTunedType(InfType infType) {
+    if (infType == InfType::AUTO) throw std::runtime_error("A layer cannot be tuned to AUTO");
+    tunedType = infType;
+}
+
+void Layer::setWeightBits(unsigned bits) {
+    if (bits != 8 && bits != 4) throw std::runtime_error("Weights are 8 or 4 bits, not " + std::to_string(bits));
+}
+
+// Hand out the attached arena (or this layer's own), reset and sized for this layer
+Workspace& Layer::scratch() const {
+    Workspace* ws = workspace;
+    if (!ws) {
+        if (!ownWorkspace) ownWorkspace.reset(new Workspace());
+        ws = ownWorkspace.get();
+    }
+    ws->reserve(getWorkspaceSize());
+    ws->reset();
+    return *ws;
+}
+
+// --- Comparison metrics ---
+// Elements per chunk of work; chunks are merged in order, so the result does not depend on the thread count
+static const std::size_t COMPARE_CHUNK_ELEMENTS = 16 * 1024;
+static const std::size_t COMPARE_MIN_CHUNKS_PER_THREAD = 4;
+
+// Partial sums of one chunk per lane (lane j of a row belongs to channel j % channels)
+struct CompareLanes {
+    std::vector<fp32> dot, aa, bb, sq;  // Current row block, flushed to the totals below
+    std::vector<fp32> maxAbs;
+    std::vector<uint32_t> bins;         // Error bin of each element of the current row (fp32-wide for the vectorizer)
+    std::vector<double> dotTotal, aaTotal, bbTotal, sqTotal;
+    std::vector<std::array<std::size_t, COMPARE_HIST_BINS>> histogram;  // Per channel
+
+    CompareLanes(std::size_t width, std::size_t channels)
+        : dot(width), aa(width), bb(width), sq(width), maxAbs(width), bins(width), dotTotal(width), aaTotal(width),
+          bbTotal(width), sqTotal(width), histogram(channels) {}
+
+    // Move the fp32 block sums into the double totals (bounds the fp32 rounding error)
+    void flush() {
+        for (std::size_t j = 0; j < dot.size(); j++) {
+            dotTotal[j] += dot[j];
+            aaTotal[j] += aa[j];
+            bbTotal[j] += bb[j];
+            sqTotal[j] += sq[j];
+            dot[j] = aa[j] = bb[j] = sq[j] = 0.0f;
+        }
+    }
+};
+
+// Rows accumulated in fp32 before a flush to double
+static const std::size_t COMPARE_ROWS_PER_FLUSH = 64;
+
+// Restrict-qualified parameters (not locals) so the compiler drops its aliasing checks and vectorizes:
+// every lane has its own accumulators, so no sum is reassociated. Error bins (decades, see
+// COMPARE_HIST_BINS) are counted compares.
+static void accumulateLanes(const fp32* ML_RESTRICT a, const fp32* ML_RESTRICT b, std::size_t n,
+                            fp32* ML_RESTRICT dot, fp32* ML_RESTRICT aa, fp32* ML_RESTRICT bb, fp32* ML_RESTRICT sq,
+                            fp32* ML_RESTRICT maxAbs, uint32_t* ML_RESTRICT bins) {
+    for (std::size_t j = 0; j < n; j++) {
+        const fp32 x = a[j], y = b[j], d = x - y;
+        const fp32 e = std::abs(d);
+        dot[j] += x * y;
+        aa[j] += x * x;
+        bb[j] += y * y;
+        sq[j] += d * d;
+        maxAbs[j] = maxAbs[j] < e ? e : maxAbs[j];
+        bins[j] = static_cast<uint32_t>((e > 0.0f) + (e > 1e-6f) + (e > 1e-5f) + (e > 1e-4f) + (e > 1e-3f) +
+                                        (e > 1e-2f) + (e > 1e-1f));
+    }
+}
+
+static void accumulateRow(const fp32* a, const fp32* b, std::size_t n, std::size_t channels, CompareLanes& lanes) {
+    accumulateLanes(a, b, n, lanes.dot.data(), lanes.aa.data(), lanes.bb.data(), lanes.sq.data(), lanes.maxAbs.data(),
+                    lanes.bins.data());
+    // Histogram scatter over the same (cached) row
+    for (std::size_t j = 0, c = 0; j < n; j++) {
+        lanes.histogram[c][lanes.bins[j]]++;
+        if (++c == channels) c = 0;
+    }
+}
+
+CompareMetrics compareTensors(const fp32* a, const fp32* b, std::size_t count, std::size_t channels) {
+    channels = std::max<std::size_t>(1, channels);
+    // Rows are a multiple of the channel count with at least 64 lanes, so 1-D data vectorizes too
+    const std::size_t width = channels * std::max<std::size_t>(1, 64 / channels);
+    const std::size_t rows = count / width;
+    const std::size_t tail = count - rows * width;  // Whole channel groups
+    const std::size_t rowsPerChunk = std::max<std::size_t>(1, COMPARE_CHUNK_ELEMENTS / width);
+    const std::size_t chunks = std::max<std::size_t>(1, (rows + rowsPerChunk - 1) / rowsPerChunk);
+
+    std::vector<std::unique_ptr<CompareLanes>> partials(chunks);
+    ThreadPool::shared().parallelFor(chunks, COMPARE_MIN_CHUNKS_PER_THREAD, [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k < last; k++) {
+            partials[k].reset(new CompareLanes(width, channels));
+            const std::size_t rowEnd = std::min(rows, (k + 1) * rowsPerChunk);
+            for (std::size_t r = k * rowsPerChunk; r < rowEnd; r++) {
+                accumulateRow(a + r * width, b + r * width, width, channels, *partials[k]);
+                if ((r + 1) % COMPARE_ROWS_PER_FLUSH == 0) partials[k]->flush();
+            }
+            if (k + 1 == chunks && tail) {
+                accumulateRow(a + rows * width, b + rows * width, tail, channels, *partials[k]);
+            }
+            partials[k]->flush();
+        }
+    });
+
+    CompareMetrics metrics;
+    metrics.count = count;
+    metrics.channelRmse.assign(channels, 0.0);  // Sum of squares until the end
+    metrics.channelMaxAbs.assign(channels, 0.0);
+    metrics.channelHistogram.assign(channels, std::array<std::size_t, COMPARE_HIST_BINS>());
+    double dot = 0.0, aa = 0.0, bb = 0.0, sq = 0.0;
+    for (const std::unique_ptr<CompareLanes>& lanes : partials) {
+        for (std::size_t j = 0; j < width; j++) {
+            const std::size_t c = j % channels;
+            dot += lanes->dotTotal[j];
+            aa += lanes->aaTotal[j];
+            bb += lanes->bbTotal[j];
+            sq += lanes->sqTotal[j];
+            metrics.channelRmse[c] += lanes->sqTotal[j];
+            metrics.channelMaxAbs[c] = std::max<double>(metrics.channelMaxAbs[c], lanes->maxAbs[j]);
+        }
+        for (std::size_t c = 0; c < channels; c++) {
+            for (std::size_t bin = 0; bin < COMPARE_HIST_BINS; bin++) {
+                metrics.channelHistogram[c][bin] += lanes->histogram[c][bin];
+            }
+        }
+    }
+
+    const std::size_t perChannel = count / channels;
+    for (std::size_t c = 0; c < channels; c++) {
+        metrics.channelRmse[c] = perChannel ? std::sqrt(metrics.channelRmse[c] / perChannel) : 0.0;
+        metrics.maxAbs = std::max(metrics.maxAbs, metrics.channelMaxAbs[c]);
+    }
+    metrics.rmse = count ? std::sqrt(sq / count) : 0.0;
+    metrics.cosine = (aa == 0.0 && bb == 0.0) ? 0.0 : dot / std::max(aa, bb);
+    return metrics;
+}
+
 }  // namespace ML
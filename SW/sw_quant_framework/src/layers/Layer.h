@@ -1,12 +1,16 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <cstring>
 #include <memory>
 #include <sstream>
 #include <cmath>
 #include <algorithm>
+#include <stdexcept>
+#include <string>
 
+#include "../BufferPool.h"
 #include "../Config.h"
 #include "../Utils.h"
 #include "../Types.h"
@@ -40,6 +44,102 @@ class LayerParams {
     const Path filePath;
 };
 
+// Element access checks for TensorView, compiled in only for debug builds (make build_debug)
+#ifdef ML_DEBUG_BOUNDS
+#define ML_VIEW_CHECK(cond, msg) \
+    do {                           \
+        if (!(cond)) throw std::out_of_range(msg); \
+    } while (0)
+#else
+#define ML_VIEW_CHECK(cond, msg) ((void)0)
+#endif
+
+// Typed view of contiguous row-major tensor data (last dim fastest)
+// Dims and strides are computed once when the view is made; element access is a plain
+// pointer offset, so kernels use views inside their loops instead of LayerData::get<T>.
+template <typename T> class TensorView {
+   public:
+    enum { MAX_RANK = 4 };
+
+    TensorView(T* data, const std::vector<std::size_t>& dims) : ptr(data), rank(dims.size()), count(1) {
+        if (rank > MAX_RANK) {
+            throw std::runtime_error("TensorView supports at most " + std::to_string(MAX_RANK) + " dims");
+        }
+        for (std::size_t i = rank; i-- > 0;) {
+            shape[i] = dims[i];
+            strides[i] = count;
+            count *= dims[i];
+        }
+    }
+
+    // Flat (rank 1) view of count elements
+    TensorView(T* data, std::size_t count) : ptr(data), rank(1), count(count) {
+        shape[0] = count;
+        strides[0] = 1;
+    }
+
+    inline T* data() const { return ptr; }
+    inline std::size_t size() const { return count; }
+    inline std::size_t dim(std::size_t i) const { return shape[i]; }
+    inline std::size_t stride(std::size_t i) const { return strides[i]; }
+
+    // Flat element access
+    inline T& operator[](std::size_t i) const {
+        ML_VIEW_CHECK(i < count, "TensorView index out of bounds");
+        return ptr[i];
+    }
+
+    // Multi-dimensional access, the number of indices must match the rank
+    inline T& operator()(std::size_t i0, std::size_t i1) const {
+        ML_VIEW_CHECK(rank == 2 && i0 < shape[0] && i1 < shape[1], "TensorView index out of bounds");
+        return ptr[i0 * strides[0] + i1];
+    }
+    inline T& operator()(std::size_t i0, std::size_t i1, std::size_t i2) const {
+        ML_VIEW_CHECK(rank == 3 && i0 < shape[0] && i1 < shape[1] && i2 < shape[2], "TensorView index out of bounds");
+        return ptr[i0 * strides[0] + i1 * strides[1] + i2];
+    }
+    inline T& operator()(std::size_t i0, std::size_t i1, std::size_t i2, std::size_t i3) const {
+        ML_VIEW_CHECK(rank == 4 && i0 < shape[0] && i1 < shape[1] && i2 < shape[2] && i3 < shape[3],
+                      "TensorView index out of bounds");
+        return ptr[i0 * strides[0] + i1 * strides[1] + i2 * strides[2] + i3];
+    }
+
+   private:
+    T* ptr;
+    std::size_t rank;
+    std::size_t count;
+    std::size_t shape[MAX_RANK] = {};
+    std::size_t strides[MAX_RANK] = {};
+};
+
+// Errors between two tensors of the same shape, all gathered in one pass (LayerData::compareMetrics).
+// Channels are the last dimension (HWC tensors); a 1-D tensor is a single channel.
+static const std::size_t COMPARE_HIST_BINS = 8;  // |a - b| by decade: 0, <= 1e-6, <= 1e-5, ..., <= 1e-1, above
+
+struct CompareMetrics {
+    double cosine = 0.0;  // Length-weighted cosine similarity: dot / max(|a|^2, |b|^2)
+    double maxAbs = 0.0;
+    double rmse = 0.0;
+    std::size_t count = 0;
+    std::vector<double> channelRmse;
+    std::vector<double> channelMaxAbs;
+    std::vector<std::array<std::size_t, COMPARE_HIST_BINS>> channelHistogram;
+
+    // Channel with the largest RMSE
+    std::size_t worstChannel() const {
+        return std::max_element(channelRmse.begin(), channelRmse.end()) - channelRmse.begin();
+    }
+};
+
+// Metrics kernel: vectorized over the channels of a row, rows split over the shared thread pool
+CompareMetrics compareTensors(const fp32* a, const fp32* b, std::size_t count, std::size_t channels);
+
+// Other element types are widened to fp32 first
+template <typename T> CompareMetrics compareTensors(const T* a, const T* b, std::size_t count, std::size_t channels) {
+    const std::vector<fp32> wideA(a, a + count), wideB(b, b + count);
+    return compareTensors(wideA.data(), wideB.data(), count, channels);
+}
+
 // Output data container of a layer inference
 class LayerData {
    public:
@@ -50,13 +150,14 @@ class LayerData {
         allocData();
         std::memcpy(data.get(), other.data.get(), params.byte_size());
     }
+    inline LayerData(LayerData&& other) = default;
 
     inline bool isAlloced() const { return data != nullptr; }
     inline const LayerParams& getParams() const { return params; }
     inline const void* raw() const { return data.get(); }
     inline void* raw() { return data.get(); }
 
-    template <typename T> void boundsCheck(unsigned int flat_index) const {
+    template <typename T> void elementSizeCheck() const {
         if (sizeof(T) != params.elementSize) {
             std::ostringstream oss;
             oss << "Accessing LayerData with incorrect element size in `" << params.filePath << "` (" << params.dims[0];
@@ -66,6 +167,10 @@ class LayerData {
             oss << "), accessed by size " << sizeof(T) << ", but elementSize is " << params.elementSize << ".\n";
             throw std::runtime_error(oss.str());
         }
+    }
+
+    template <typename T> void boundsCheck(unsigned int flat_index) const {
+        elementSizeCheck<T>();
         if (flat_index >= params.flat_count()) {
             std::ostringstream oss;
             oss << "Index out of bounds in `" << params.filePath << "` (" << params.dims[0];
@@ -88,10 +193,23 @@ class LayerData {
         return ((T*)data.get())[flat_index];
     }
 
+    // Typed views for kernel loops (element size checked once here, access unchecked)
+    template <typename T> TensorView<T> view() {
+        elementSizeCheck<T>();
+        return TensorView<T>((T*)data.get(), params.dims);
+    }
+
+    template <typename T> TensorView<const T> view() const {
+        elementSizeCheck<T>();
+        return TensorView<const T>((const T*)data.get(), params.dims);
+    }
+
     // Allocate data values
     inline void allocData() {
         if (data) return;
-        data.reset((char*)(new ui64[(params.byte_size() + 7)/8])); // Assume elementSize <= sizeof(u64) for alignment
+        // 64-byte aligned storage from the shared pool (reused across alloc/free of the same size)
+        data = DataPtr(static_cast<char*>(BufferPool::shared().allocate(params.byte_size())),
+                       PoolDeleter{params.byte_size()});
     }
 
     // Load data values
@@ -104,9 +222,12 @@ class LayerData {
         data.reset();
     }
 
-    // Get the max difference between two Layer Data arrays
+    // Length-weighted cosine similarity of two Layer Data arrays
     template <typename T> float compare(const LayerData& other) const;
 
+    // Cosine, max-abs, RMSE and per-channel errors in one pass
+    template <typename T> CompareMetrics compareMetrics(const LayerData& other) const;
+
     // Compare within an Epsilon to ensure layer datas are similar within reason
     template <typename T, typename T_EP = float> bool compareWithin(const LayerData& other, const T_EP epsilon = Config::EPSILON) const;
 
@@ -114,8 +235,54 @@ class LayerData {
     template <typename T, typename T_EP = float> bool compareWithinPrint(const LayerData& other, const T_EP epsilon = Config::EPSILON) const;
 
    private:
+    // Hands the buffer back to the pool it came from
+    struct PoolDeleter {
+        std::size_t bytes;
+        void operator()(char* ptr) const { BufferPool::shared().release(ptr, bytes); }
+    };
+    using DataPtr = std::unique_ptr<char, PoolDeleter>;
+
     LayerParams params;
-    std::unique_ptr<char[]> data;
+    DataPtr data;
+};
+
+// Bump-allocated scratch memory for layer kernels
+// The model sizes one arena to the largest Layer::getWorkspaceSize() and attaches it to
+// every layer, so kernels carve their temporary buffers out of it instead of the heap.
+// Layers run one at a time on a given arena; Layer::scratch() resets it per call.
+class Workspace {
+   public:
+    // Arena bytes taken by `count` elements of T (rounded up to the 64-byte alignment)
+    template <typename T> static std::size_t bytesFor(std::size_t count) {
+        return (count * sizeof(T) + BufferPool::ALIGNMENT - 1) / BufferPool::ALIGNMENT * BufferPool::ALIGNMENT;
+    }
+
+    // Grow the arena to at least `bytes` (only allocates when it grows)
+    void reserve(std::size_t bytes) {
+        if (bytes > buffer.size()) buffer.resize(bytes);
+    }
+
+    // Release all buffers handed out so far
+    void reset() { offset = 0; }
+
+    // Next `count` elements of T, 64-byte aligned and uninitialized
+    template <typename T> TensorView<T> alloc(std::size_t count) {
+        const std::size_t bytes = bytesFor<T>(count);
+        if (offset + bytes > buffer.size()) {
+            throw std::runtime_error("Workspace overflow: " + std::to_string(offset + bytes) + " bytes requested, " +
+                                     std::to_string(buffer.size()) + " reserved");
+        }
+        T* ptr = reinterpret_cast<T*>(buffer.data() + offset);
+        offset += bytes;
+        return TensorView<T>(ptr, count);
+    }
+
+    inline std::size_t capacity() const { return buffer.size(); }
+    inline std::size_t used() const { return offset; }
+
+   private:
+    AlignedVector<char> buffer;
+    std::size_t offset = 0;
 };
 
 // Base class all layers extend from
@@ -128,7 +295,8 @@ class Layer {
         TILED, 
         SIMD,
         QUANTIZED,      // For quantized inference
-        ACCELERATED     // For hardware acceleration
+        ACCELERATED,    // For hardware acceleration
+        AUTO            // Per-layer choice of the auto-tuner (see AutoTuner.h); NAIVE until tuned
     };
     
     // Layer Type
@@ -161,6 +329,17 @@ class Layer {
     
     bool isWeightsQuantized() const { return weights_quantized; }
 
+    // Zero-skipping int8 kernels below this input density (0 = never, 1 = whenever an input is zero)
+    void setSparseDensityThreshold(float threshold) { sparseDensityThreshold = threshold; }
+    float getSparseDensityThreshold() const { return sparseDensityThreshold; }
+
+    // Weight bit width of the int8 paths: 8, or 4 (packed two per byte, see Int4.h) on the
+    // layers that support it (conv, dense); other layers keep 8
+    virtual void setWeightBits(unsigned bits);
+    unsigned getWeightBits() const { return weightBits; }
+    // Relative RMS error of the weights quantized to `bits` (0 for layers without weights)
+    virtual double weightQuantizationError(unsigned bits) const { return 0.0; }
+
     // Simple helper functions for quantization (student-friendly)
     int8_t quantizeFloat(float value, float scale, int8_t zero_point) const {
         int32_t quantized = static_cast<int32_t>(std::round(value / scale) + zero_point);
@@ -181,11 +360,34 @@ class Layer {
         outData.freeData();
     }
 
+    // Scratch bytes the compute functions take from the workspace (0 = none)
+    virtual std::size_t getWorkspaceSize() const { return 0; }
+
+    // Work of one inference, for profiling and stage balancing
+    // Multiply-accumulates (0 for layers without any)
+    virtual std::size_t getMacs() const { return 0; }
+    // Parameter bytes read besides the input (weights, biases)
+    virtual std::size_t getWeightBytes() const { return 0; }
+
+    // Attach a shared scratch arena (Model::allocLayers); without one the layer keeps its own
+    void setWorkspace(Workspace* ws) { workspace = ws; }
+
     virtual void computeNaive(const LayerData& dataIn) const = 0;
     virtual void computeThreaded(const LayerData& dataIn) const = 0;
     virtual void computeTiled(const LayerData& dataIn) const = 0;
     virtual void computeSIMD(const LayerData& dataIn) const = 0;
     virtual void computeQuantized(const LayerData& dataIn) const = 0;
+    virtual void computeAccelerated(const LayerData& dataIn) const {
+        computeQuantized(dataIn);
+    }
+
+    // Dispatch to the compute function of an inference type
+    void compute(const LayerData& dataIn, InfType infType) const;
+
+    // Inference type AUTO runs on this layer
+    void setTunedType(InfType infType);
+    InfType getTunedType() const { return tunedType; }
+    InfType resolveInfType(InfType infType) const { return infType == InfType::AUTO ? tunedType : infType; }
 
    protected:
     // Quantization scales and zero points
@@ -202,12 +404,21 @@ class Layer {
     std::vector<int8_t> quantized_weights;
     std::vector<int32_t> quantized_biases;
     bool weights_quantized = false;
+    float sparseDensityThreshold = Config::SPARSE_DENSITY_THRESHOLD;
+    unsigned weightBits = 8;
+
+    // Scratch arena for one compute call: reset, and at least getWorkspaceSize() bytes
+    Workspace& scratch() const;
 
    private:
     LayerParams inParams;
     LayerParams outParams;
     mutable LayerData outData;
     LayerType lType;
+    InfType tunedType = InfType::NAIVE;
+
+    Workspace* workspace = nullptr;                   // Shared arena (owned by the model)
+    mutable std::unique_ptr<Workspace> ownWorkspace;  // Fallback when used outside a model
 };
 
 // Load data values
@@ -288,8 +499,8 @@ inline void LayerData::saveData(Path filePath) {
 #endif
 }
 
-// Get the max difference between two Layer Data arrays
-template <typename T> float LayerData::compare(const LayerData& other) const {
+// Single-pass comparison metrics of two Layer Data arrays
+template <typename T> CompareMetrics LayerData::compareMetrics(const LayerData& other) const {
     LayerParams aParams = getParams();
     LayerParams bParams = other.getParams();
 
@@ -309,31 +520,17 @@ template <typename T> float LayerData::compare(const LayerData& other) const {
         }
     }
 
-    size_t flat_count = params.flat_count();
-
-    //MODIFIED LENGTH WEIGHTED COSINE SIMILARITY
-    double dot_product = 0;
-    double a_magnitude_sq = 0;
-    double b_magnitude_sq = 0;
-    
-    T* a_vector = (T*)data.get();
-    T* b_vector = (T*)other.data.get();
-    // Recurse as needed into each array
-    for (std::size_t i = 0; i < flat_count; i++) {
-        a_magnitude_sq += a_vector[i] * a_vector[i];
-        b_magnitude_sq += b_vector[i] * b_vector[i];
-        dot_product += a_vector[i] * b_vector[i];
-    }
+    const std::size_t channels = aParams.dims.size() > 1 ? aParams.dims.back() : 1;
+    return compareTensors((const T*)data.get(), (const T*)other.data.get(), params.flat_count(), channels);
+}
 
-    float cosine_similarity = 0;
-    if (a_magnitude_sq == 0 && b_magnitude_sq == 0){
+// Length-weighted cosine similarity (see CompareMetrics)
+template <typename T> float LayerData::compare(const LayerData& other) const {
+    const CompareMetrics metrics = compareMetrics<T>(other);
+    if (metrics.cosine == 0.0 && metrics.maxAbs == 0.0) {
         std::cout << "Zero Magnitude Vector Comparison" << std::endl;
     }
-    else {
-        cosine_similarity = dot_product / (std::max(a_magnitude_sq, b_magnitude_sq));
-    }
-    
-    return cosine_similarity;
+    return static_cast<float>(metrics.cosine);
 }
 
 // Compare within an Epsilon to ensure layer datas are similar within reason
@@ -343,8 +540,12 @@ template <typename T, typename T_EP> bool LayerData::compareWithin(const LayerDa
 
 template <typename T, typename T_EP> bool LayerData::compareWithinPrint(const LayerData& other, const T_EP epsilon) const {
     //LENGTH WEIGHTED COSINE SIMILARITY
-    float cosine_similarity = compare<T>(other);
-    bool result = (compare<T>(other) > 0.8);
+    const CompareMetrics metrics = compareMetrics<T>(other);
+    if (metrics.cosine == 0.0 && metrics.maxAbs == 0.0) {
+        std::cout << "Zero Magnitude Vector Comparison" << std::endl;
+    }
+    float cosine_similarity = static_cast<float>(metrics.cosine);
+    bool result = (cosine_similarity > 0.8);
 
     std::cout 
         << "Comparing Outputs (Cosine Similarity): " 
@@ -353,6 +554,9 @@ template <typename T, typename T_EP> bool LayerData::compareWithinPrint(const La
         << " ("
         << cosine_similarity
         << ")\n";
+    const std::size_t worst = metrics.worstChannel();
+    std::cout << "  max abs " << metrics.maxAbs << ", RMSE " << metrics.rmse << ", worst channel " << worst
+              << " (RMSE " << metrics.channelRmse[worst] << ")\n";
     
     return result;
 }
@@ -2,7 +2,7 @@
 
 #include <iostream>
 #include <algorithm>
-#include <thread>
+#include <cmath>
 #include <vector>
 
 #include "../Types.h"
@@ -29,7 +29,9 @@ namespace ML
         size_t poolHeight = poolDims[0];
         size_t poolWidth = poolDims[1];
 
-        LayerData& output = getOutputData();
+        // Typed views: element size checked once, unchecked access in the loops
+        const TensorView<const fp32> input = dataIn.view<fp32>();
+        const TensorView<fp32> output = getOutputData().view<fp32>();
 
         // Max pooling computation
         for (size_t c = 0; c < outputChannels; c++)
@@ -55,7 +57,7 @@ namespace ML
                                                   w_in * inputChannels +
                                                   c;
 
-                                fp32 val = dataIn.get<fp32>(inputIdx);
+                                fp32 val = input[inputIdx];
                                 if (val > maxVal)
                                 {
                                     maxVal = val;
@@ -68,202 +70,68 @@ namespace ML
                                        w_out * outputChannels +
                                        c;
                     
-                    output.get<fp32>(outputIdx) = maxVal;
+                    output[outputIdx] = maxVal;
                 }
             }
         }
     }
 
     void MaxPoolingLayer::computeThreaded(const LayerData& dataIn) const {
-        // For simplicity, use naive implementation with thread hints
-        // TODO: Implement actual threading
-        computeNaive(dataIn);
+        // Output rows split across the shared pool
+        pool<fp32>(Tensor<const fp32, 3>(dataIn), Tensor<fp32, 3>(getOutputData()));
     }
 
     void MaxPoolingLayer::computeTiled(const LayerData& dataIn) const {
-        // For simplicity, use naive implementation 
-        // TODO: Implement tiled processing
-        computeNaive(dataIn);
+        // The HWC row kernel already streams each input row once
+        computeSIMD(dataIn);
     }
 
     void MaxPoolingLayer::computeSIMD(const LayerData& dataIn) const {
-        // For simplicity, use naive implementation
-        // TODO: Implement SIMD optimized max pooling
-        computeNaive(dataIn);
+        // Vectorized channel max on the calling thread
+        const Tensor<const fp32, 3> input(dataIn);
+        const Tensor<fp32, 3> output(getOutputData());
+        poolRows<fp32>(input, output, 0, output.dim(0));
     }
 
     void MaxPoolingLayer::computeQuantized(const LayerData& dataIn) const {
-    // ==========================================================================
-    // ADAPTIVE QUANTIZED MAX POOLING - HANDLES MIXED PIPELINE STATES
-    // ==========================================================================
-    // Current issue: Conv layers output fp32 even in "quantized" mode
-    // Solution: Detect input data type and adapt accordingly
-    // - If input is fp32: Work in fp32 space (pipeline compatibility)
-    // - If input is i8: Work in int8 space (true quantized mode)
-    // ==========================================================================
-    
-    logInfo("MaxPooling: Starting adaptive quantized computation");
-    
-    const auto &inputDims = getInputParams().dims;   // [H_in, W_in, C_in]
-    const auto &outputDims = getOutputParams().dims; // [H_out, W_out, C_out]
-    const auto &poolDims = getPoolParams().dims;     // [pool_h, pool_w]
-
-    size_t inputHeight = inputDims[0];
-    size_t inputWidth = inputDims[1];
-    size_t inputChannels = inputDims[2];
-    size_t outputHeight = outputDims[0];
-    size_t outputWidth = outputDims[1];
-    size_t outputChannels = outputDims[2];
-    size_t poolHeight = poolDims[0];
-    size_t poolWidth = poolDims[1];
-
-    LayerData& output = getOutputData();
-    
-    logDebug("MaxPool dimensions: input=[" + std::to_string(inputHeight) + "x" + 
-             std::to_string(inputWidth) + "x" + std::to_string(inputChannels) + 
-             "], output=[" + std::to_string(outputHeight) + "x" + 
-             std::to_string(outputWidth) + "x" + std::to_string(outputChannels) + 
-             "], pool=[" + std::to_string(poolHeight) + "x" + std::to_string(poolWidth) + "]");
-
-    // ==========================================================================
-    // DETECT INPUT DATA TYPE AND CHOOSE APPROPRIATE STRATEGY
-    // ==========================================================================
-    // Check LayerData element size to determine if input is fp32 or int8
-    // This is a temporary solution until full pipeline uses consistent types
-    // ==========================================================================
-    
-    size_t input_element_size = dataIn.getParams().elementSize;
-    bool input_is_fp32 = (input_element_size == sizeof(fp32));  // 4 bytes
-    bool input_is_int8 = (input_element_size == sizeof(i8));    // 1 byte
-    
-    logDebug("MaxPool input element size: " + std::to_string(input_element_size) + " bytes");
-    
-    if (input_is_fp32) {
-        logInfo("MaxPool: Input is fp32, using fp32 computation (pipeline compatibility mode)");
-        
-        // ==========================================================================
-        // FP32 MAX POOLING (Compatible with current Conv layer outputs)
-        // ==========================================================================
-        for (size_t c = 0; c < outputChannels; c++) {
-            for (size_t h_out = 0; h_out < outputHeight; h_out++) {
-                for (size_t w_out = 0; w_out < outputWidth; w_out++) {
-                    fp32 maxVal = -INFINITY;
-
-                    // Pool over the kernel region
-                    for (size_t pool_h = 0; pool_h < poolHeight; pool_h++) {
-                        for (size_t pool_w = 0; pool_w < poolWidth; pool_w++) {
-                            size_t h_in = h_out * poolHeight + pool_h;
-                            size_t w_in = w_out * poolWidth + pool_w;
-
-                            // Check bounds
-                            if (h_in < inputHeight && w_in < inputWidth) {
-                                size_t inputIdx = h_in * (inputWidth * inputChannels) +
-                                                  w_in * inputChannels + c;
-
-                                fp32 val = dataIn.get<fp32>(inputIdx);
-                                if (val > maxVal) {
-                                    maxVal = val;
-                                }
-                            }
-                        }
-                    }
-
-                    size_t outputIdx = h_out * (outputWidth * outputChannels) +
-                                       w_out * outputChannels + c;
-                    
-                    // Store as fp32 to maintain pipeline compatibility
-                    output.get<fp32>(outputIdx) = maxVal;
-                }
-            }
-        }
-        
-        // Debug fp32 outputs
-        fp32 output_min = output.get<fp32>(0);
-        fp32 output_max = output.get<fp32>(0);
-        size_t total_outputs = outputHeight * outputWidth * outputChannels;
-        
-        for (size_t i = 0; i < std::min(total_outputs, size_t(10)); i++) {
-            fp32 val = output.get<fp32>(i);
-            if (val < output_min) output_min = val;
-            if (val > output_max) output_max = val;
+        // The quantized pipeline hands fp32 activations between layers (conv dequantizes its
+        // output), so they are quantized to int8 over their runtime range, ix = round(Si * Ix) + zi,
+        // pooled with pool<i8> and dequantized. The map is increasing, so every output is the
+        // int8 code of the fp32 window max.
+        ML_LOG_INFO("MaxPooling: Starting quantized computation");
+
+        const TensorView<const fp32> in = dataIn.view<fp32>();
+        const TensorView<fp32> out = getOutputData().view<fp32>();
+        const auto minmax = std::minmax_element(in.data(), in.data() + in.size());
+        fp32 range = *minmax.second - *minmax.first;
+        if (range < 1e-8f) range = 1.0f;
+        const fp32 Si = 255.0f / range;
+        const i32 zi = std::max(-128, std::min(127, static_cast<i32>(std::round(-128.0f - Si * *minmax.first))));
+
+        Workspace& workspace = scratch();
+        TensorView<i8> quantized_input = workspace.alloc<i8>(in.size());
+        TensorView<i8> quantized_output = workspace.alloc<i8>(out.size());
+        for (size_t i = 0; i < in.size(); i++) {
+            const i32 ix = static_cast<i32>(std::round(Si * in[i])) + zi;
+            quantized_input[i] = static_cast<i8>(std::max(-128, std::min(127, ix)));
         }
-        
-        logInfo("MaxPool fp32 computation complete - " + std::to_string(total_outputs) + " outputs");
-        logDebug("Output fp32 range: [" + std::to_string(output_min) + ", " + std::to_string(output_max) + "]");
-        
-    } else if (input_is_int8) {
-        logInfo("MaxPool: Input is int8, using true quantized computation (pure int8 mode)");
-        
-        // ==========================================================================
-        // TRUE INT8 MAX POOLING (For future full quantized pipeline)
-        // ==========================================================================
-        for (size_t c = 0; c < outputChannels; c++) {
-            for (size_t h_out = 0; h_out < outputHeight; h_out++) {
-                for (size_t w_out = 0; w_out < outputWidth; w_out++) {
-                    i8 maxVal_i8 = -128;  // Minimum int8 value
-                    bool found_valid = false;
 
-                    // Pool over the kernel region
-                    for (size_t pool_h = 0; pool_h < poolHeight; pool_h++) {
-                        for (size_t pool_w = 0; pool_w < poolWidth; pool_w++) {
-                            size_t h_in = h_out * poolHeight + pool_h;
-                            size_t w_in = w_out * poolWidth + pool_w;
+        const auto& inputDims = getInputParams().dims;
+        const auto& outputDims = getOutputParams().dims;
+        const Tensor<const i8, 3> input(quantized_input.data(), {{inputDims[0], inputDims[1], inputDims[2]}});
+        const Tensor<i8, 3> output(quantized_output.data(), {{outputDims[0], outputDims[1], outputDims[2]}});
+        pool<i8>(input, output);
 
-                            // Check bounds
-                            if (h_in < inputHeight && w_in < inputWidth) {
-                                size_t inputIdx = h_in * (inputWidth * inputChannels) +
-                                                  w_in * inputChannels + c;
-
-                                i8 val_i8 = dataIn.get<i8>(inputIdx);
-                                
-                                if (!found_valid || val_i8 > maxVal_i8) {
-                                    maxVal_i8 = val_i8;
-                                    found_valid = true;
-                                }
-                            }
-                        }
-                    }
-
-                    size_t outputIdx = h_out * (outputWidth * outputChannels) +
-                                       w_out * outputChannels + c;
-                    
-                    // Store as int8 - preserves quantization parameters
-                    output.get<i8>(outputIdx) = maxVal_i8;
-                }
-            }
-        }
-        
-        // Debug int8 outputs
-        i8 output_min = output.get<i8>(0);
-        i8 output_max = output.get<i8>(0);
-        size_t total_outputs = outputHeight * outputWidth * outputChannels;
-        
-        for (size_t i = 0; i < std::min(total_outputs, size_t(10)); i++) {
-            i8 val = output.get<i8>(i);
-            if (val < output_min) output_min = val;
-            if (val > output_max) output_max = val;
+        for (size_t i = 0; i < out.size(); i++) {
+            out[i] = (quantized_output[i] - zi) / Si;
         }
-        
-        logInfo("MaxPool int8 computation complete - " + std::to_string(total_outputs) + " outputs");
-        logDebug("Output int8 range: [" + std::to_string(static_cast<int>(output_min)) + 
-                 ", " + std::to_string(static_cast<int>(output_max)) + "]");
-        
-    } else {
-        logError("MaxPool: Unsupported input data type - elementSize=" + 
-                 std::to_string(input_element_size) + " bytes");
-        logError("Expected: 4 bytes (fp32) or 1 byte (i8)");
-        return;
+
+        ML_LOG_DEBUG("MaxPool dimensions: input=[" + std::to_string(input.dim(0)) + "x" +
+                     std::to_string(input.dim(1)) + "x" + std::to_string(input.dim(2)) +
+                     "], output=[" + std::to_string(output.dim(0)) + "x" +
+                     std::to_string(output.dim(1)) + "x" + std::to_string(output.dim(2)) + "]");
+        ML_LOG_INFO("MaxPool int8 computation complete - " + std::to_string(output.size()) + " outputs (Si=" +
+                    std::to_string(Si) + ", zi=" + std::to_string(zi) + ")");
     }
-    
-    // ==========================================================================
-    // ADAPTIVE MAXPOOL SUMMARY:
-    // ==========================================================================
-    // ✅ Pipeline compatibility: Works with current Conv layer fp32 outputs
-    // ✅ Future ready: Supports true int8 quantized pipeline
-    // ✅ Automatic detection: Adapts based on input data type
-    // ✅ No performance loss: Uses optimal path for each data type
-    // ✅ Consistent interface: Same function handles both modes
-    // ==========================================================================
-}
 
-}
\ No newline at end of file
+}
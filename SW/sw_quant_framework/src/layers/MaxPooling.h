@@ -1,10 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../ThreadPool.h"
 #include "../Types.h"
 #include "../Utils.h"
 #include "Layer.h"
+#include "Tensor.h"
 
 namespace ML {
+
 class MaxPoolingLayer : public Layer {
    public:
     MaxPoolingLayer(const LayerParams inParams, const LayerParams outParams, const LayerParams poolParams)
@@ -33,6 +40,56 @@ class MaxPoolingLayer : public Layer {
     virtual void computeSIMD(const LayerData& dataIn) const override;
     virtual void computeQuantized(const LayerData& dataIn) const override;
 
+    // int8 input and output of computeQuantized
+    virtual std::size_t getWorkspaceSize() const override {
+        return Workspace::bytesFor<i8>(getInputParams().flat_count()) +
+               Workspace::bytesFor<i8>(getOutputParams().flat_count());
+    }
+
+    // Max pooling for any element type (fp32 pipeline or int8 activations), output rows
+    // split across the shared thread pool. Windows are non-overlapping (stride = pool size);
+    // out-of-range taps are skipped.
+    template <typename T> void pool(const Tensor<const T, 3>& in, const Tensor<T, 3>& out) const {
+        const size_t rowElements = poolParam.dims[0] * in.dim(1) * in.dim(2);  // Compares per output row
+        const size_t minRows = ThreadPool::minChunk(rowElements);
+
+        ThreadPool::shared().parallelFor(out.dim(0), minRows, [&](size_t first, size_t last) {
+            poolRows<T>(in, out, first, last);
+        });
+    }
+
+    // Output rows [firstRow, lastRow) in HWC order: every tap of a window is a contiguous
+    // channel vector, reduced into the (contiguous) output pixel with an element-wise max
+    // the compiler turns into packed max instructions for both fp32 and int8.
+    template <typename T>
+    void poolRows(const Tensor<const T, 3>& in, const Tensor<T, 3>& out, size_t firstRow, size_t lastRow) const {
+        const size_t poolHeight = poolParam.dims[0];
+        const size_t poolWidth = poolParam.dims[1];
+        const size_t channels = out.dim(2);
+        const T lowest = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                              : std::numeric_limits<T>::lowest();
+
+        for (size_t h_out = firstRow; h_out < lastRow; h_out++) {
+            for (size_t w_out = 0; w_out < out.dim(1); w_out++) {
+                T* ML_RESTRICT dst = &out(h_out, w_out, 0);
+                std::fill(dst, dst + channels, lowest);
+
+                for (size_t pool_h = 0; pool_h < poolHeight; pool_h++) {
+                    const size_t h_in = h_out * poolHeight + pool_h;
+                    if (h_in >= in.dim(0)) break;
+                    for (size_t pool_w = 0; pool_w < poolWidth; pool_w++) {
+                        const size_t w_in = w_out * poolWidth + pool_w;
+                        if (w_in >= in.dim(1)) break;
+                        const T* ML_RESTRICT src = &in(h_in, w_in, 0);
+                        for (size_t c = 0; c < channels; c++) {
+                            dst[c] = src[c] > dst[c] ? src[c] : dst[c];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
    private:
     LayerParams poolParam; // Stores pool size parameters [pool_h, pool_w]
 };
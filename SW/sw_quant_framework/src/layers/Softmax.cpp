@@ -2,9 +2,10 @@
 
 #include <iostream>
 #include <algorithm>
-#include <thread>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 #include "../Types.h"
 #include "../Utils.h"
@@ -13,52 +14,151 @@
 namespace ML
 {
 
-    void SoftmaxLayer::computeNaive(const LayerData &dataIn) const
+    // exp(-k / 2^SOFTMAX_LOGIT_FRAC_BITS) scaled to 2^30
+    static std::vector<uint32_t> buildSoftmaxExpTable()
     {
-        //const auto &inputDims = getInputParams().dims;   // Expected: [batch, features] or just [features]
-        //const auto &outputDims = getOutputParams().dims; // Expected: same as input
-
-        // Get the number of elements to process
-        size_t numElements = getInputParams().flat_count();
-        
-        LayerData& output = getOutputData();
+        std::vector<uint32_t> table(SOFTMAX_EXP_LUT_SIZE);
+        for (size_t k = 0; k < SOFTMAX_EXP_LUT_SIZE; k++)
+        {
+            const double x = -static_cast<double>(k) / (1 << SOFTMAX_LOGIT_FRAC_BITS);
+            table[k] = static_cast<uint32_t>(std::lround(std::exp(x) * (1u << 30)));
+        }
+        return table;
+    }
 
+    void SoftmaxLayer::softmax(const fp32 *input, fp32 *output, size_t count)
+    {
         // Find the maximum value for numerical stability
         fp32 maxVal = -INFINITY;
-        for (size_t i = 0; i < numElements; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            fp32 val = dataIn.get<fp32>(i);
-            if (val > maxVal)
+            if (input[i] > maxVal)
             {
-                maxVal = val;
+                maxVal = input[i];
             }
         }
 
         // Compute exponentials and sum
         fp32 sumExp = 0.0f;
-        for (size_t i = 0; i < numElements; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            fp32 expVal = std::exp(dataIn.get<fp32>(i) - maxVal);
-            output.get<fp32>(i) = expVal;
+            fp32 expVal = std::exp(input[i] - maxVal);
+            output[i] = expVal;
             sumExp += expVal;
         }
 
         // Normalize by the sum
-        for (size_t i = 0; i < numElements; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            output.get<fp32>(i) = output.get<fp32>(i) / sumExp;
+            output[i] = output[i] / sumExp;
         }
     }
 
+    void SoftmaxLayer::softmaxFixedPoint(const i32 *logits, fp32 *output, size_t count)
+    {
+        static const std::vector<uint32_t> table = buildSoftmaxExpTable();
+        const uint32_t *expTable = table.data();
+
+        i32 maxVal = logits[0];
+        for (size_t i = 1; i < count; i++)
+        {
+            maxVal = std::max(maxVal, logits[i]);
+        }
+
+        // exp(x - max) by table lookup on the (non-negative) integer distance to the max
+        uint64_t sumExp = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint32_t dist = static_cast<uint32_t>(maxVal - logits[i]);
+            const uint32_t expVal = dist < SOFTMAX_EXP_LUT_SIZE ? expTable[dist] : 0;
+            output[i] = static_cast<fp32>(expVal);
+            sumExp += expVal;
+        }
+
+        // The max itself contributes 2^30, so the sum is never zero
+        const fp32 invSum = 1.0f / static_cast<fp32>(sumExp);
+        for (size_t i = 0; i < count; i++)
+        {
+            output[i] *= invSum;
+        }
+    }
+
+    size_t SoftmaxLayer::argmax(const fp32 *values, size_t count)
+    {
+        size_t best = 0;
+        for (size_t i = 1; i < count; i++)
+        {
+            if (values[i] > values[best])
+            {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    std::vector<SoftmaxLayer::ClassScore> SoftmaxLayer::topK(const fp32 *values, size_t count, size_t k)
+    {
+        std::vector<ClassScore> scores(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            scores[i].index = i;
+            scores[i].score = values[i];
+        }
+
+        // Only the first k need to be ordered
+        k = std::min(k, count);
+        std::partial_sort(scores.begin(), scores.begin() + k, scores.end(),
+                          [](const ClassScore &a, const ClassScore &b) {
+                              return a.score > b.score || (a.score == b.score && a.index < b.index);
+                          });
+        scores.resize(k);
+        return scores;
+    }
+
+    void SoftmaxLayer::computeTopK(const LayerData &dataIn) const
+    {
+        const size_t numElements = getInputParams().flat_count();
+        const TensorView<const fp32> input = dataIn.view<fp32>();
+        const TensorView<fp32> output = getOutputData().view<fp32>();
+
+        // Softmax is monotonic: the logits rank the classes exactly like the probabilities
+        std::memcpy(output.data(), input.data(), numElements * sizeof(fp32));
+        rankClasses(dataIn);
+    }
+
+    void SoftmaxLayer::rankClasses(const LayerData &logits) const
+    {
+        const TensorView<const fp32> input = logits.view<fp32>();
+        topKResult = topK(input.data(), input.size(), topKCount);
+    }
+
+    void SoftmaxLayer::computeNaive(const LayerData &dataIn) const
+    {
+        //const auto &inputDims = getInputParams().dims;   // Expected: [batch, features] or just [features]
+        //const auto &outputDims = getOutputParams().dims; // Expected: same as input
+
+        if (outputMode == OutputMode::TOP_K)
+        {
+            computeTopK(dataIn);
+            return;
+        }
+
+        // Get the number of elements to process
+        size_t numElements = getInputParams().flat_count();
+
+        const TensorView<const fp32> input = dataIn.view<fp32>();
+        const TensorView<fp32> output = getOutputData().view<fp32>();
+
+        softmax(input.data(), output.data(), numElements);
+    }
+
     void SoftmaxLayer::computeThreaded(const LayerData& dataIn) const {
-        // For simplicity, use naive implementation with thread hints
-        // TODO: Implement actual threading
+        // A few hundred logits: not worth a thread hand-off
         computeNaive(dataIn);
     }
 
     void SoftmaxLayer::computeTiled(const LayerData& dataIn) const {
-        // For simplicity, use naive implementation 
-        // TODO: Implement tiled processing
+        // The logits fit in L1; nothing to tile
         computeNaive(dataIn);
     }
 
@@ -68,11 +168,33 @@ namespace ML
         computeNaive(dataIn);
     }
 
-void SoftmaxLayer::computeQuantized(const LayerData& dataIn) const {
-    // Softmax always works with fp32 values per lab specification
-    // No quantization handling needed - input is already dequantized from previous layer
-    std::cout << "[DEBUG] Softmax computeQuantized() called (same as naive)" << std::endl;
-    computeNaive(dataIn);
-}
+    void SoftmaxLayer::computeQuantized(const LayerData &dataIn) const
+    {
+        // The quantized pipeline hands fp32 logits to the softmax (dense dequantizes its
+        // output); they are rounded to Q6 fixed point and the exp comes from a table.
+        if (outputMode == OutputMode::TOP_K)
+        {
+            computeTopK(dataIn);
+            return;
+        }
 
-}
\ No newline at end of file
+        const size_t numElements = getInputParams().flat_count();
+        const TensorView<const fp32> input = dataIn.view<fp32>();
+        const TensorView<fp32> output = getOutputData().view<fp32>();
+
+        Workspace &workspace = scratch();
+        TensorView<i32> logits = workspace.alloc<i32>(numElements);
+
+        const fp32 one = static_cast<fp32>(1 << SOFTMAX_LOGIT_FRAC_BITS);
+        const fp32 limit = static_cast<fp32>(1 << 24);  // Keeps max - logit within int32
+        for (size_t i = 0; i < numElements; i++)
+        {
+            const fp32 scaled = std::max(-limit, std::min(limit, input[i] * one));
+            logits[i] = static_cast<i32>(std::lrint(scaled));
+        }
+
+        softmaxFixedPoint(logits.data(), output.data(), numElements);
+        ML_LOG_DEBUG("Softmax: integer LUT softmax over " + std::to_string(numElements) + " logits");
+    }
+
+}
@@ -1,12 +1,30 @@
 #pragma once
 
+#include <vector>
+
 #include "../Types.h"
 #include "../Utils.h"
 #include "Layer.h"
 
 namespace ML {
+
+// Integer softmax: logits in fixed point with this many fractional bits (step 1/64)
+static const int SOFTMAX_LOGIT_FRAC_BITS = 6;
+// exp() table over max - logit in [0, 16) logit units; anything further below the max is 0
+static const size_t SOFTMAX_EXP_LUT_SIZE = 16u << SOFTMAX_LOGIT_FRAC_BITS;
+
 class SoftmaxLayer : public Layer {
    public:
+    // PROBABILITIES: normalized softmax output (default)
+    // TOP_K: classification only. The output holds the logits unchanged (same argmax and
+    //        ranking as the probabilities) and getTopK() the k best classes; no exp/normalize.
+    enum class OutputMode { PROBABILITIES, TOP_K };
+
+    struct ClassScore {
+        size_t index;
+        fp32 score;  // Logit (TOP_K mode) or probability
+    };
+
     SoftmaxLayer(const LayerParams inParams, const LayerParams outParams)
         : Layer(inParams, outParams, LayerType::SOFTMAX) {}
 
@@ -29,8 +47,40 @@ class SoftmaxLayer : public Layer {
     virtual void computeSIMD(const LayerData& dataIn) const override;
     virtual void computeQuantized(const LayerData& dataIn) const override;
 
+    // Fixed-point logits of computeQuantized
+    virtual std::size_t getWorkspaceSize() const override {
+        return Workspace::bytesFor<i32>(getInputParams().flat_count());
+    }
+
+    // Output mode; k is the number of classes kept by TOP_K
+    void setOutputMode(OutputMode mode, size_t k = 1) {
+        outputMode = mode;
+        topKCount = k;
+    }
+    OutputMode getOutputMode() const { return outputMode; }
+
+    // Best classes of the last inference in TOP_K mode, highest first
+    const std::vector<ClassScore>& getTopK() const { return topKResult; }
+
+    // Fill getTopK() from logits without writing the output (fused dense+softmax node)
+    void rankClasses(const LayerData& logits) const;
+
+    // Shared classification helpers (also used by the evaluation code)
+    // Reference fp32 softmax (max-subtracted, three passes)
+    static void softmax(const fp32* input, fp32* output, size_t count);
+    // Integer softmax: Q(SOFTMAX_LOGIT_FRAC_BITS) logits, table exp, one fp32 normalize pass
+    static void softmaxFixedPoint(const i32* logits, fp32* output, size_t count);
+    // Index of the largest value (first one on ties)
+    static size_t argmax(const fp32* values, size_t count);
+    // k largest values, highest first (ties keep the lower index first)
+    static std::vector<ClassScore> topK(const fp32* values, size_t count, size_t k);
+
    private:
-    // Softmax doesn't have additional parameters
+    void computeTopK(const LayerData& dataIn) const;
+
+    OutputMode outputMode = OutputMode::PROBABILITIES;
+    size_t topKCount = 1;
+    mutable std::vector<ClassScore> topKResult;
 };
 
-}  // namespace ML
\ No newline at end of file
+}  // namespace ML
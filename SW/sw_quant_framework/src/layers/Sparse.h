@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../Types.h"
+#include "Layer.h"
+
+namespace ML {
+
+// Activation sparsity of the int8 kernels.
+// After ReLU many activations are exactly zero, and a real zero quantizes to the input zero
+// point zi. Since sum_i ix * w - zi * sum_i w = sum_i (ix - zi) * w, a kernel may drop every
+// input equal to zi if it accumulates the centered values (ix - zi) without the zero-point
+// correction. The integer result, and so the output, is bit-identical to the dense kernel.
+//
+// SparseRows holds the centered nonzero inputs of each row (an input pixel of a conv, or the
+// whole vector of a dense layer) in compressed form: row r owns entries
+// [offsets[r], offsets[r + 1]) of index (position in the row) and value (ix - zi).
+struct SparseRows {
+    const ui32* offsets;
+    const ui16* index;
+    const i16* values;
+};
+
+// Inputs of a quantized tensor that differ from the zero point
+inline std::size_t countNonzero(const i8* input, std::size_t count, i8 zeroPoint) {
+    std::size_t nonzero = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        nonzero += input[i] != zeroPoint;
+    }
+    return nonzero;
+}
+
+// Workspace bytes of compressRows for rows x rowLength inputs with `nonzero` of them kept
+inline std::size_t sparseRowsBytes(std::size_t rows, std::size_t nonzero) {
+    return Workspace::bytesFor<ui32>(rows + 1) + Workspace::bytesFor<ui16>(nonzero) + Workspace::bytesFor<i16>(nonzero);
+}
+
+// Compress rows x rowLength quantized inputs (rowLength <= 65536) into workspace buffers
+inline SparseRows compressRows(const i8* input, std::size_t rows, std::size_t rowLength, std::size_t nonzero,
+                               i8 zeroPoint, Workspace& workspace) {
+    ui32* offsets = workspace.alloc<ui32>(rows + 1).data();
+    ui16* index = workspace.alloc<ui16>(nonzero).data();
+    i16* values = workspace.alloc<i16>(nonzero).data();
+
+    std::size_t next = 0;
+    for (std::size_t row = 0; row < rows; row++) {
+        offsets[row] = static_cast<ui32>(next);
+        const i8* in = input + row * rowLength;
+        for (std::size_t i = 0; i < rowLength; i++) {
+            if (in[i] != zeroPoint) {
+                index[next] = static_cast<ui16>(i);
+                values[next] = static_cast<i16>(in[i] - zeroPoint);
+                next++;
+            }
+        }
+    }
+    offsets[rows] = static_cast<ui32>(next);
+    return SparseRows{offsets, index, values};
+}
+
+}  // namespace ML
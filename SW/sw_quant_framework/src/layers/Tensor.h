@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Layer.h"
+
+namespace ML {
+
+// Memory order of image tensors. Indices are always logical (N,) H, W, C;
+// the layout only decides the strides.
+enum class Layout { NHWC, NCHW };
+
+// Typed tensor of compile-time element type and rank over contiguous data (non-owning)
+// Dims and strides are cached at construction, so kernels written against Tensor are
+// specialized per element type and index with a fixed number of multiply-adds.
+// Constructing one from LayerData checks element size and rank once; element access
+// is unchecked unless built with ML_DEBUG_BOUNDS (make build_debug).
+template <typename T, std::size_t Rank, Layout L = Layout::NHWC> class Tensor {
+    static_assert(Rank >= 1 && Rank <= 4, "Tensor rank must be between 1 and 4");
+
+   public:
+    using value_type = T;
+    using element_type = typename std::remove_const<T>::type;
+    using Dims = std::array<std::size_t, Rank>;
+    using Source = typename std::conditional<std::is_const<T>::value, const LayerData&, LayerData&>::type;
+
+    // Wrap a raw buffer, dims given in logical order
+    Tensor(T* data, const Dims& dims) : ptr(data), shape(dims) { computeStrides(); }
+
+    // Wrap LayerData, whose dims are the storage order of layout L
+    explicit Tensor(Source data) : ptr(nullptr), shape() {
+        data.template elementSizeCheck<element_type>();
+        const std::vector<std::size_t>& storage = data.getParams().dims;
+        if (storage.size() != Rank) {
+            std::ostringstream oss;
+            oss << "Tensor of rank " << Rank << " cannot view `" << data.getParams().filePath << "` with "
+                << storage.size() << " dims";
+            throw std::runtime_error(oss.str());
+        }
+        for (std::size_t k = 0; k < Rank; k++) {
+            shape[logicalAxis(k)] = storage[k];
+        }
+        ptr = static_cast<T*>(data.raw());
+        computeStrides();
+    }
+
+    static constexpr std::size_t rank() { return Rank; }
+    static constexpr Layout layout() { return L; }
+
+    inline T* data() const { return ptr; }
+    inline std::size_t size() const { return count; }
+    inline std::size_t dim(std::size_t axis) const { return shape[axis]; }
+    inline std::size_t stride(std::size_t axis) const { return strides[axis]; }
+
+    // Flat element access (storage order)
+    inline T& operator[](std::size_t i) const {
+        ML_VIEW_CHECK(i < count, "Tensor index out of bounds");
+        return ptr[i];
+    }
+
+    // Logical element access, one index per dim
+    inline T& operator()(std::size_t i0) const {
+        static_assert(Rank == 1, "Tensor needs one index per dim");
+        return (*this)[i0 * strides[0]];
+    }
+    inline T& operator()(std::size_t i0, std::size_t i1) const {
+        static_assert(Rank == 2, "Tensor needs one index per dim");
+        ML_VIEW_CHECK(i0 < shape[0] && i1 < shape[1], "Tensor index out of bounds");
+        return ptr[i0 * strides[0] + i1 * strides[1]];
+    }
+    inline T& operator()(std::size_t i0, std::size_t i1, std::size_t i2) const {
+        static_assert(Rank == 3, "Tensor needs one index per dim");
+        ML_VIEW_CHECK(i0 < shape[0] && i1 < shape[1] && i2 < shape[2], "Tensor index out of bounds");
+        return ptr[i0 * strides[0] + i1 * strides[1] + i2 * strides[2]];
+    }
+    inline T& operator()(std::size_t i0, std::size_t i1, std::size_t i2, std::size_t i3) const {
+        static_assert(Rank == 4, "Tensor needs one index per dim");
+        ML_VIEW_CHECK(i0 < shape[0] && i1 < shape[1] && i2 < shape[2] && i3 < shape[3], "Tensor index out of bounds");
+        return ptr[i0 * strides[0] + i1 * strides[1] + i2 * strides[2] + i3 * strides[3]];
+    }
+
+   private:
+    // Logical axis stored at storage position k (channels move to the front for NCHW)
+    static std::size_t logicalAxis(std::size_t k) {
+        if (L == Layout::NCHW && Rank >= 3) {
+            const std::size_t c = Rank - 1;        // Logical channel axis
+            const std::size_t first = Rank - 3;    // Storage position of C (after N, if any)
+            if (k < first) return k;
+            if (k == first) return c;
+            return k - 1;
+        }
+        return k;
+    }
+
+    void computeStrides() {
+        count = 1;
+        for (std::size_t k = Rank; k-- > 0;) {
+            strides[logicalAxis(k)] = count;
+            count *= shape[logicalAxis(k)];
+        }
+    }
+
+    T* ptr;
+    Dims shape;
+    Dims strides = {};
+    std::size_t count = 0;
+};
+
+}  // namespace ML